@@ -169,6 +169,13 @@ namespace Internal {  // DCF77_Flag_Decoder
         }
     }
 
+    void DCF77_Flag_Decoder::set_DCF77_Encoder(DCF77_Encoder &now) {
+        now.abnormal_transmitter_operation = get_abnormal_transmitter_operation();
+        now.timezone_change_scheduled      = get_timezone_change_scheduled();
+        now.uses_summertime                = get_uses_summertime();
+        now.leap_second_scheduled          = get_leap_second_scheduled();
+    }
+
     void DCF77_Flag_Decoder::reset_after_previous_hour() {
         // HH := hh+1
         // timezone_change_scheduled will be set from hh:01 to HH:00
@@ -290,6 +297,10 @@ namespace Internal { // DCF77_Year_Decoder
         Decade_Decoder.process_tick(current_second, tick_value);
     }
 
+    void DCF77_Year_Decoder::set_DCF77_Encoder(DCF77_Encoder &now) {
+        now.year = get_time_value();
+    }
+
     void DCF77_Year_Decoder::get_quality(lock_quality_t &lock_quality) {
         Binning::Decoder<DCF77_Year_template_parameters::decoder_t::data_type,
                          DCF77_Year_template_parameters::decoder_t::number_of_bins>::get_quality(lock_quality);
@@ -368,6 +379,10 @@ namespace Internal {  // DCF77_Month_Decoder
         BCD_binning<DCF77_Month_template_parameters::BCD_binning_t> (current_second, tick_value);
     }
 
+    void DCF77_Month_Decoder::set_DCF77_Encoder(DCF77_Encoder &now) {
+        now.month = get_time_value();
+    }
+
     void DCF77_Month_Decoder::debug() {
         sprint(F("Month: "));
         Binning::Decoder<DCF77_Month_template_parameters::decoder_t::data_type,
@@ -394,6 +409,10 @@ namespace Internal {  // DCF77_Weekday_Decoder
         BCD_binning<DCF77_Weekday_template_parameters::BCD_binning_t> (current_second, tick_value);
 }
 
+    void DCF77_Weekday_Decoder::set_DCF77_Encoder(DCF77_Encoder &now) {
+        now.weekday = get_time_value();
+    }
+
     void DCF77_Weekday_Decoder::debug() {
         sprint(F("Weekday: "));
         Binning::Decoder<DCF77_Weekday_template_parameters::decoder_t::data_type,
@@ -423,6 +442,10 @@ namespace Internal {  // DCF77_Day_Decoder
         BCD_binning<DCF77_Day_template_parameters::BCD_binning_t> (current_second, tick_value);
     }
 
+    void DCF77_Day_Decoder::set_DCF77_Encoder(DCF77_Encoder &now) {
+        now.day = get_time_value();
+    }
+
     void DCF77_Day_Decoder::debug() {
         sprint(F("Day: "));
         Binning::Decoder<DCF77_Day_template_parameters::decoder_t::data_type,
@@ -453,6 +476,10 @@ namespace Internal {  // DCF77_Hour_Decoder
         BCD_binning<DCF77_Hour_template_parameters::BCD_binning_t> (current_second, tick_value);
     }
 
+    void DCF77_Hour_Decoder::set_DCF77_Encoder(DCF77_Encoder &now) {
+        now.hour = get_time_value();
+    }
+
     void DCF77_Hour_Decoder::debug() {
         sprint(F("Hour: "));
         Binning::Decoder<DCF77_Hour_template_parameters::decoder_t::data_type,
@@ -505,6 +532,8 @@ namespace Internal {  // DCF77_Second_Decoder
     };
 
     void DCF77_Second_Decoder::set_convolution_time(const DCF77_Encoder &now) {
+        DCF77_MARK_TICK_PATH(convolution_time);
+
         DCF77_Encoder convolution_clock = now;
 
         // we are always decoding the data for the NEXT minute
@@ -513,10 +542,37 @@ namespace Internal {  // DCF77_Second_Decoder
         // the convolution kernel shall have proper flag settings
         convolution_clock.autoset_control_bits();
 
+        DCF77::serialized_clock_stream convolution_kernel;
         convolution_clock.get_serialized_clock_stream(convolution_kernel);
+
+        // Bit i of the frame is the predicted bit of second i. Bit 0 is always 0,
+        // bit 16 is where the convolution kernel starts, it ends with bit 58.
+        uint64_t frame = 0;
+        for (int8_t byte_index = 5; byte_index >= 0; --byte_index) {
+            frame = frame << 8 | (&(convolution_kernel.byte_0))[byte_index];
+        }
+        frame = (frame >> 3) << 16;
+        const uint64_t predicted = 1 | ((((uint64_t)1 << 43) - 1) << 16);
+
+        // The next call of convolution_binning will score bin b with second
+        // tick-1-b of the frame. Thus the frame is reversed and rotated once.
+        // Afterwards each call just rotates by one bin.
+        prediction_bits = 0;
+        prediction_mask = 0;
+        uint8_t second = this->tick>0? this->tick-1: seconds_per_minute-1;
+        for (uint8_t bin = 0; bin < seconds_per_minute; ++bin) {
+            prediction_bits |= ((frame     >> second) & 1) << bin;
+            prediction_mask |= ((predicted >> second) & 1) << bin;
+            second = second>0? second-1: seconds_per_minute-1;
+        }
+
         prediction_match = 0;
     }
 
+    uint64_t DCF77_Second_Decoder::rotate_bins(const uint64_t bins) {
+        return ((bins << 1) | (bins >> (seconds_per_minute-1))) & ((((uint64_t)1) << seconds_per_minute) - 1);
+    }
+
     void DCF77_Second_Decoder::convolution_binning(const uint8_t tick_data) {
         using namespace Arithmetic_Tools;
 
@@ -550,46 +606,28 @@ namespace Internal {  // DCF77_Second_Decoder
                 prediction_match += 6;
             }
         } else if (tick_data == DCF77::short_tick || tick_data == DCF77::long_tick) {
-            uint8_t decoded_bit = (tick_data == DCF77::long_tick);
-
-            // bit 0 always 0
-            uint8_t bin = this->tick>0? this->tick-1: seconds_per_minute-1;
-            const bool is_match = (decoded_bit == 0);
-            this->data[bin] += is_match;
-            if (bin == this->signal_max_index) {
-                prediction_match += is_match;
-            }
-
-            // bit 16 is where the convolution kernel starts
-            bin = bin>15? bin-16: bin + seconds_per_minute-16;
-            uint8_t current_byte_index = 0;
-            uint8_t current_bit_index = 3;
-            uint8_t current_byte_value = convolution_kernel.byte_0 >> 3;
-            while (current_byte_index < 6) {
-                while (current_bit_index < 8) {
-                    const uint8_t current_bit_value = current_byte_value & 1;
-                    const bool is_match = (decoded_bit == current_bit_value);
-
-                    this->data[bin] += is_match;
-                    if (bin == this->signal_max_index) {
-                        prediction_match += is_match;
-                    }
-
-                    bin = bin>0? bin-1: seconds_per_minute-1;
+            // bit b is set if the decoded bit matches the prediction for bin b
+            const uint64_t matches = (tick_data == DCF77::long_tick? prediction_bits: ~prediction_bits) & prediction_mask;
 
-                    current_byte_value >>= 1;
-                    ++current_bit_index;
+            // Each bin gets at most one match, thus the match of the
+            // current phase is just one bit.
+            if (this->signal_max_index < seconds_per_minute) {
+                prediction_match += (matches >> this->signal_max_index) & 1;
+            }
 
-                    if (current_byte_index == 5 && current_bit_index > 5) {
-                        break;
-                    }
+            // bytewise, zero bytes and trailing zeros are skipped
+            const uint8_t *match_bytes = (const uint8_t *)&matches;
+            for (uint8_t first_bin = 0; first_bin < seconds_per_minute; first_bin += 8) {
+                uint8_t bin = first_bin;
+                for (uint8_t byte_value = match_bytes[first_bin / 8]; byte_value; byte_value >>= 1) {
+                    this->data[bin] += byte_value & 1;
+                    ++bin;
                 }
-                current_bit_index = 0;
-                ++current_byte_index;
-                current_byte_value = (&(convolution_kernel.byte_0))[current_byte_index];
             }
         }
 
+        prediction_bits = rotate_bins(prediction_bits);
+        prediction_mask = rotate_bins(prediction_mask);
         this->tick = this->tick<seconds_per_minute-1? this->tick+1: 0;
     }
 
@@ -933,6 +971,12 @@ namespace Internal {  // DCF77_Encoder
     }
 
     void DCF77_Encoder::autoset_control_bits() {
+        // without a date, e.g. if Configuration::decode_date is false,
+        // the control bits can not be derived and are left as they are
+        if (month.val > 0x12) {
+            return;
+        }
+
         autoset_weekday();
         autoset_timezone();
         autoset_timezone_change_scheduled();
@@ -1295,6 +1339,187 @@ namespace Internal {  // DCF77_Encoder
     }
 }
 
+namespace Internal {  // DCF77_Scheduler
+    static_assert(DCF77_Scheduler::second_slots <= 64 && (DCF77_Scheduler::second_slots & (DCF77_Scheduler::second_slots - 1)) == 0,
+                  "the second slot must be determined by the seconds only");
+
+    // year, month, day | hour, 0 for summer time, minute, second
+    // When summer time ends the hour 2 occurs twice, first with summer time.
+    // Otherwise the summer time bit is irrelevant for the order as the hour
+    // is compared first.
+    uint64_t DCF77_Scheduler::get_instant(const Clock::time_t &time) {
+        const uint16_t date = (BCD::bcd_to_int(time.year)  << 9) |
+                              (BCD::bcd_to_int(time.month) << 5) |
+                               BCD::bcd_to_int(time.day);
+        const uint32_t time_of_day = ((uint32_t)BCD::bcd_to_int(time.hour) << 13) |
+                                     ((uint32_t)!time.uses_summertime << 12) |
+                                     (BCD::bcd_to_int(time.minute) << 6) |
+                                      BCD::bcd_to_int(time.second);
+        return ((uint64_t)date << 18) | time_of_day;
+    }
+
+    uint64_t DCF77_Scheduler::get_instant(const DCF77_Encoder &time) {
+        Clock::time_t now;
+        DCF77_Clock::convert_time(time, now);
+        return get_instant(now);
+    }
+
+    void DCF77_Scheduler::setup() {
+        for (uint8_t slot = 0; slot <= due_slot; ++slot) {
+            slots[slot] = 0;
+        }
+        armed_timers = 0;
+        running = false;
+        time_sequence = 0;
+        current_millisecond = 0;
+        current_instant = 0;
+        next_time.reset();
+    }
+
+    void DCF77_Scheduler::link(Clock::timer_t &timer, const uint8_t slot) {
+        timer.prev = 0;
+        timer.next = slots[slot];
+        if (timer.next) { timer.next->prev = &timer; }
+        slots[slot] = &timer;
+        timer.slot = slot;
+    }
+
+    void DCF77_Scheduler::unlink(Clock::timer_t &timer) {
+        if (timer.prev) {
+            timer.prev->next = timer.next;
+        } else {
+            slots[timer.slot] = timer.next;
+        }
+        if (timer.next) { timer.next->prev = timer.prev; }
+        timer.prev = 0;
+        timer.next = 0;
+        timer.slot = not_armed;
+    }
+
+    void DCF77_Scheduler::arm(Clock::timer_t &timer) {
+        if (running && (timer.instant < current_instant ||
+                        (timer.instant == current_instant && timer.millisecond <= current_millisecond))) {
+            link(timer, due_slot);
+        } else if (running && timer.instant == current_instant) {
+            link(timer, second_slots + timer.millisecond % millisecond_slots);
+        } else {
+            // the lowest bits of the instant are the second
+            link(timer, timer.instant % second_slots);
+        }
+    }
+
+    void DCF77_Scheduler::schedule(Clock::timer_t &timer, const uint64_t instant, const uint16_t millisecond,
+                                   const Clock::timer_action_t action) {
+        CRITICAL_SECTION {
+            if (timer.slot != not_armed) {
+                unlink(timer);
+            } else {
+                ++armed_timers;
+            }
+            timer.instant = instant;
+            timer.millisecond = millisecond;
+            timer.action = action;
+            arm(timer);
+        }
+    }
+
+    void DCF77_Scheduler::cancel(Clock::timer_t &timer) {
+        CRITICAL_SECTION {
+            if (timer.slot != not_armed) {
+                unlink(timer);
+                --armed_timers;
+            }
+        }
+    }
+
+    void DCF77_Scheduler::process_second_slot(const uint8_t slot) {
+        for (Clock::timer_t *timer = slots[slot]; timer; ) {
+            Clock::timer_t *next = timer->next;
+            if (timer->instant <= current_instant) {
+                unlink(*timer);
+                arm(*timer);
+            }
+            timer = next;
+        }
+    }
+
+    void DCF77_Scheduler::process_millisecond_slot(const uint8_t slot) {
+        for (Clock::timer_t *timer = slots[slot]; timer; ) {
+            Clock::timer_t *next = timer->next;
+            if (timer->millisecond <= current_millisecond) {
+                unlink(*timer);
+                link(*timer, due_slot);
+            }
+            timer = next;
+        }
+    }
+
+    void DCF77_Scheduler::process_due_timers() {
+        while (slots[due_slot]) {
+            Clock::timer_t &timer = *slots[due_slot];
+            unlink(timer);
+            --armed_timers;
+            if (timer.action) { timer.action(); }
+        }
+    }
+
+    void DCF77_Scheduler::process_1_kHz_tick(const Clock::clock_state_t clock_state, const uint8_t new_time_sequence,
+                                             const DCF77_Encoder &now, const uint16_t millisecond) {
+        if (armed_timers == 0) {
+            // nothing to do, the next timer that gets armed restarts the scheduler
+            running = false;
+            return;
+        }
+
+        if (clock_state == Clock::useless || clock_state == Clock::dirty) {
+            // the timers stay armed, they will be processed once the clock is good enough
+            running = false;
+            return;
+        }
+
+        current_millisecond = millisecond;
+        if (!running || new_time_sequence != time_sequence) {
+            time_sequence = new_time_sequence;
+
+            const uint64_t instant = get_instant(now);
+            // if the instant did not change the second just restarted in phase
+            if (!running || instant != current_instant) {
+                const bool continuous = running && instant == get_instant(next_time);
+
+                current_instant = instant;
+                next_time = now;
+                next_time.advance_second();
+                running = true;
+
+                // The timers that are left in the millisecond wheel are usually
+                // overdue. However after a discontinuity they may be in the future.
+                for (uint8_t slot = second_slots; slot < due_slot; ++slot) {
+                    for (Clock::timer_t *timer = slots[slot]; timer; ) {
+                        Clock::timer_t *next = timer->next;
+                        unlink(*timer);
+                        arm(*timer);
+                        timer = next;
+                    }
+                }
+
+                if (continuous && now.second != 0) {
+                    process_second_slot(instant % second_slots);
+                } else {
+                    // The clock jumped, any timer may be due. The same holds for the
+                    // start of each minute as summer time starts or ends at minute
+                    // boundaries. The cost is one scan of all timers per minute.
+                    for (uint8_t slot = 0; slot < second_slots; ++slot) {
+                        process_second_slot(slot);
+                    }
+                }
+            }
+        }
+
+        process_millisecond_slot(second_slots + millisecond % millisecond_slots);
+        process_due_timers();
+    }
+}
+
 namespace Internal {
     namespace DCF77_Naive_Bitstream_Decoder {
         using namespace DCF77;
@@ -1392,46 +1617,29 @@ namespace Internal {
     }
 }
 
-namespace Internal {  // DCF77_Clock_Controller<Configuration, Frequency_Control>
-    // static member definitions for DCF77_Clock_Controller<Configuration, Frequency_Control>
-    template <typename Configuration, typename Frequency_Control> Clock::output_handler_t DCF77_Clock_Controller<Configuration, Frequency_Control>::output_handler = 0;
-
-    template <typename Configuration, typename Frequency_Control> DCF77_Second_Decoder  DCF77_Clock_Controller<Configuration, Frequency_Control>::Second_Decoder;
-    template <typename Configuration, typename Frequency_Control> DCF77_Minute_Decoder  DCF77_Clock_Controller<Configuration, Frequency_Control>::Minute_Decoder;
-    template <typename Configuration, typename Frequency_Control> DCF77_Hour_Decoder    DCF77_Clock_Controller<Configuration, Frequency_Control>::Hour_Decoder;
-    template <typename Configuration, typename Frequency_Control> DCF77_Weekday_Decoder DCF77_Clock_Controller<Configuration, Frequency_Control>::Weekday_Decoder;
-    template <typename Configuration, typename Frequency_Control> DCF77_Day_Decoder     DCF77_Clock_Controller<Configuration, Frequency_Control>::Day_Decoder;
-    template <typename Configuration, typename Frequency_Control> DCF77_Month_Decoder   DCF77_Clock_Controller<Configuration, Frequency_Control>::Month_Decoder;
-    template <typename Configuration, typename Frequency_Control> DCF77_Year_Decoder    DCF77_Clock_Controller<Configuration, Frequency_Control>::Year_Decoder;
-    template <typename Configuration, typename Frequency_Control> DCF77_Flag_Decoder    DCF77_Clock_Controller<Configuration, Frequency_Control>::Flag_Decoder;
-
-    template <typename Configuration, typename Frequency_Control> uint8_t       DCF77_Clock_Controller<Configuration, Frequency_Control>::leap_second;
-    template <typename Configuration, typename Frequency_Control> DCF77_Encoder DCF77_Clock_Controller<Configuration, Frequency_Control>::decoded_time;
-
-    template <typename Configuration, typename Frequency_Control> DCF77_Local_Clock<DCF77_Clock_Controller<Configuration, Frequency_Control> >
-        DCF77_Clock_Controller<Configuration, Frequency_Control>::Local_Clock;
-
-    template <typename Configuration, typename Frequency_Control> DCF77_Demodulator<DCF77_Clock_Controller<Configuration, Frequency_Control> >
-        DCF77_Clock_Controller<Configuration, Frequency_Control>::Demodulator;
-}
-
 namespace DCF77_Clock {
     using namespace Internal;
 
-    typedef DCF77_Clock_Controller<Configuration, DCF77_Frequency_Control> Clock_Controller;
+    Clock_Controller the_clock_controller;
+    Sample_Queue the_sample_queue;
+    DCF77_Scheduler the_scheduler;
 
     void setup() {
-        Clock_Controller::setup();
+        the_clock_controller.setup();
+        the_sample_queue.setup();
+        the_scheduler.setup();
     }
 
     void setup(const Clock::input_provider_t input_provider, const Clock::output_handler_t output_handler) {
-        Clock_Controller::setup();
-        Clock_Controller::set_output_handler(output_handler);
+        the_clock_controller.setup();
+        the_sample_queue.setup();
+        the_scheduler.setup();
+        the_clock_controller.set_output_handler(output_handler);
         Generic_1_kHz_Generator::setup(input_provider);
     };
 
     void debug() {
-        Clock_Controller::debug();
+        the_clock_controller.debug();
     }
 
     void set_input_provider(const Clock::input_provider_t input_provider) {
@@ -1439,7 +1647,7 @@ namespace DCF77_Clock {
     }
 
     void set_output_handler(const Clock::output_handler_t output_handler) {
-        Clock_Controller::set_output_handler(output_handler);
+        the_clock_controller.set_output_handler(output_handler);
     }
 
     void convert_time(const DCF77_Encoder &current_time, Clock::time_t &now) {
@@ -1457,21 +1665,57 @@ namespace DCF77_Clock {
 
     void get_current_time(Clock::time_t &now) {
         DCF77_Encoder current_time;
-        Clock_Controller::get_current_time(current_time);
+        if (Configuration::deferred_processing) {
+            // the clock will only advance while we poll, hence this must be
+            // called from loop(), never from an interrupt
+            const volatile bool &second_toggle = the_clock_controller.Local_Clock.second_toggle;
+            for (bool stopper = second_toggle; stopper == second_toggle; ) {
+                poll();
+            }
+            the_clock_controller.read_current_time(current_time);
+        } else {
+            the_clock_controller.get_current_time(current_time);
+        }
 
         convert_time(current_time, now);
     };
 
+    bool try_get_current_time(Clock::time_t &now) {
+        // the clock will only advance while we poll
+        poll();
+
+        DCF77_Encoder current_time;
+        if (the_clock_controller.try_get_current_time(current_time)) {
+            convert_time(current_time, now);
+            return true;
+        }
+        return false;
+    }
+
     void read_current_time(Clock::time_t &now) {
         DCF77_Encoder current_time;
-        Clock_Controller::read_current_time(current_time);
+        the_clock_controller.read_current_time(current_time);
 
         convert_time(current_time, now);
     };
 
+    void read_current_time(Clock::time_t &now, uint16_t &millisecond) {
+        DCF77_Encoder current_time;
+        the_clock_controller.read_current_time(current_time, millisecond);
+
+        convert_time(current_time, now);
+    }
+
+    uint64_t get_monotonic_milliseconds() {
+        // the clock will only advance while we poll
+        poll();
+
+        return the_clock_controller.get_monotonic_milliseconds();
+    }
+
     void read_future_time(Clock::time_t &now_plus_1s) {
         DCF77_Encoder current_time;
-        Clock_Controller::read_current_time(current_time);
+        the_clock_controller.read_current_time(current_time);
         current_time.advance_second();
 
         convert_time(current_time, now_plus_1s);
@@ -1503,158 +1747,98 @@ namespace DCF77_Clock {
     }
 
     uint8_t get_overall_quality_factor() {
-        return Clock_Controller::get_overall_quality_factor();
+        return the_clock_controller.get_overall_quality_factor();
     };
 
     Clock::clock_state_t get_clock_state() {
-        return Clock_Controller::get_clock_state();
+        return the_clock_controller.get_clock_state();
     };
 
     uint8_t get_prediction_match() {
-        return Clock_Controller::get_prediction_match();
+        return the_clock_controller.get_prediction_match();
     };
-}
 
-namespace Internal {  // DCF77_Frequency_Control
-    volatile int8_t DCF77_Frequency_Control::confirmed_precision = 0;
-    // get the adjust step that was used for the last adjustment
-    //   if there was no adjustment or if the phase drift was poor it will return 0
-    int8_t DCF77_Frequency_Control::get_confirmed_precision() {
-        return confirmed_precision;
+    void poll() {
+        if (!Configuration::deferred_processing) { return; }
+
+        uint8_t samples;
+        while (the_sample_queue.pop(samples)) {
+            for (uint8_t i = 0; i < 8; ++i) {
+                the_clock_controller.process_1_kHz_tick_data(samples & 1);
+                process_timers();
+                samples >>= 1;
+            }
+        }
     }
 
-    void DCF77_Frequency_Control::qualify_calibration() {
-        calibration_state.qualified = true;
-    };
+    void process_timers() {
+        const DCF77_Local_Clock<Clock_Controller> &local_clock = the_clock_controller.Local_Clock;
+        the_scheduler.process_1_kHz_tick(local_clock.clock_state, local_clock.time_sequence,
+                                         local_clock.local_clock_time, min(local_clock.tick, (uint16_t)999));
+    }
 
-    void DCF77_Frequency_Control::unqualify_calibration() {
-        calibration_state.qualified = false;
-    };
+    void schedule(Clock::timer_t &timer, const Clock::time_t &time, const uint16_t millisecond,
+                  const Clock::timer_action_t action) {
+        the_scheduler.schedule(timer, DCF77_Scheduler::get_instant(time), millisecond, action);
+    }
 
-    DCF77_Frequency_Control::deviation_tracker_t DCF77_Frequency_Control::deviation_tracker;
-    int16_t DCF77_Frequency_Control::compute_phase_deviation(uint8_t current_second, uint8_t current_minute_mod_10) {
-        return deviation_tracker.compute_phase_deviation(current_second, current_minute_mod_10);
-    }
-
-    volatile DCF77_Frequency_Control::calibration_state_t DCF77_Frequency_Control::calibration_state = {false ,false};
-    DCF77_Frequency_Control::calibration_state_t DCF77_Frequency_Control::get_calibration_state() {
-        return *(calibration_state_t *)&calibration_state;
-    }
-
-    volatile int16_t DCF77_Frequency_Control::deviation;
-    int16_t DCF77_Frequency_Control::get_current_deviation() {
-        return deviation;
-    }
-
-    void DCF77_Frequency_Control::adjust() {
-        int16_t total_adjust = Generic_1_kHz_Generator::read_adjustment();
-        // The proper formula would be
-        //     int32_t adjust == (16 000 000 / (elapsed_minutes * 60 * phase_lock_resolution)) * new_deviation;
-        // The total error of the formula below is ~ 1/(3*elapsed_minutes)
-        //     which is  ~ 1/1000 (for centisecond resolution) and ~1/100 for millisecond resolution
-        // Also notice that 2667*deviation will not overflow even if the
-        // local clock would deviate by more than 400 ppm or 6 kHz
-        // from its nominal frequency.
-        // Finally notice that the frequency_offset will always be rounded towards zero
-        // while the confirmed_precision is rounded away from zero. The first should
-        // be considered a kind of relaxation while the second should be considered
-        // a defensive computation.
-        const int16_t minutes_per_16000000_ticks = 16000000uL / 60 / Configuration::phase_lock_resolution;
-        const int16_t frequency_offset = ((minutes_per_16000000_ticks * (int32_t)deviation) /
-                                           deviation_tracker.elapsed_minutes);
-        // In doubt confirmed precision will be slightly larger than the true value
-        confirmed_precision = ((minutes_per_16000000_ticks - 1) + deviation_tracker.elapsed_minutes) /
-                                deviation_tracker.elapsed_minutes;
-        if (confirmed_precision == 0) { confirmed_precision = 1; }
-
-        total_adjust -= frequency_offset;
-
-        if (total_adjust >  max_total_adjust) { total_adjust =  max_total_adjust; }
-        if (total_adjust < -max_total_adjust) { total_adjust = -max_total_adjust; }
-
-        Generic_1_kHz_Generator::adjust(total_adjust);
-    }
-
-    void DCF77_Frequency_Control::process_1_Hz_tick(const DCF77_Encoder &decoded_time) {
-        const int16_t deviation_to_trigger_readjust = 5;
-
-        deviation = compute_phase_deviation(decoded_time.second, decoded_time.minute.digit.lo);
-
-        if (decoded_time.second == calibration_second) {
-            // We might be in an unqualified state and thus the leap second information
-            // we have might be wrong.
-            // However if we fail to detect an actual leap second, calibration will be wrong
-            // by 1 second.
-            // Therefore we assume a leap second and verify_leap_second_scheduled()
-            // will tell us if our assumption could actually be a leap second.
-            if (decoded_time.verify_leap_second_scheduled(true)) {
-                // Leap seconds will mess up our frequency computations.
-                // Handling them properly would be slightly more complicated.
-                // Since leap seconds may only happen every 3 months we just
-                // stop calibration for leap seconds and do nothing else.
-                calibration_state.running = false;
-            }
+    void cancel(Clock::timer_t &timer) {
+        the_scheduler.cancel(timer);
+    }
 
-            if (calibration_state.running) {
-                if (calibration_state.qualified) {
-                    if ((Configuration::has_stable_ambient_temperature && deviation_tracker.good_enough() && abs(deviation) >= deviation_to_trigger_readjust) ||
-                         deviation_tracker.timeout()) {
-                        adjust();
-                        DCF77_Clock_Controller<Configuration, DCF77_Frequency_Control>::on_tuned_clock();
+    bool is_armed(const Clock::timer_t &timer) {
+        return timer.slot != DCF77_Scheduler::not_armed;
+    }
 
-                        // restart calibration next second
-                        calibration_state.running = false;
-                    }
-                } else {
-                    // unqualified
-                    if (deviation_tracker.timeout()) {
-                        // running unqualified for more than tau minutes
-                        //   --> the current calibration attempt is doomed
-                        calibration_state.running = false;
-                    }
-                    // else running but unqualified --> wait for better state
-                }
-            } else {
-                // (calibration_state.running == false) --> waiting
-                if (calibration_state.qualified) {
-                    deviation_tracker.start(decoded_time.minute.digit.lo);
-                    calibration_state.running = true;
-                }
-                // else waiting but unqualified --> nothing to do
-            }
+    uint32_t get_lost_samples() {
+        uint32_t lost_samples;
+        CRITICAL_SECTION {
+            lost_samples = the_sample_queue.lost_samples;
         }
+        return lost_samples;
     }
 
-    void DCF77_Frequency_Control::process_1_kHz_tick() {
-        deviation_tracker.process_tick();
+    uint16_t get_max_queued_samples() {
+        return 8 * (uint16_t)the_sample_queue.max_queued_bytes;
     }
 
-    void DCF77_Frequency_Control::setup() {}
-
-    void DCF77_Frequency_Control::debug() {
-        using namespace Debug;
-        sprintln(F("confirmed_precision ?? adjustment, deviation, elapsed"));
-        sprintpp16m(confirmed_precision);
-        sprint(F(", "));
-        sprint(calibration_state.running? '@': '.');
-        sprint(calibration_state.qualified? '+': '-');
-        sprint(' ');
+    // The snapshot of the clock controller is followed by
+    // the phase deviation of the generator, least significant byte first.
+    uint16_t get_snapshot_size() {
+        return Clock_Controller::snapshot_size + sizeof(int32_t);
+    }
 
-        sprint(F(", "));
-        sprintpp16m(Generic_1_kHz_Generator::read_adjustment());
-        sprint(F(", "));
+    void save_snapshot(uint8_t *snapshot) {
+        CRITICAL_SECTION {
+            the_clock_controller.save_snapshot(snapshot);
 
-        sprint(deviation);
-        sprint(F(" ticks, "));
+            const uint32_t phase_deviation = Generic_1_kHz_Generator::read_phase_deviation();
+            for (uint8_t i = 0; i < sizeof(int32_t); ++i) {
+                snapshot[Clock_Controller::snapshot_size + i] = phase_deviation >> (8 * i);
+            }
+        }
+    }
 
-        sprint(deviation_tracker.elapsed_minutes);
-        sprint(F(" min + "));
-        sprint(deviation_tracker.elapsed_ticks_mod_60000);
-        sprintln(F(" ticks mod 60000"));
+    bool restore_snapshot(const uint8_t *snapshot) {
+        bool restored = false;
+        CRITICAL_SECTION {
+            restored = the_clock_controller.restore_snapshot(snapshot);
+            if (restored) {
+                uint32_t phase_deviation = 0;
+                for (uint8_t i = 0; i < sizeof(int32_t); ++i) {
+                    phase_deviation |= (uint32_t)snapshot[Clock_Controller::snapshot_size + i] << (8 * i);
+                }
+                Generic_1_kHz_Generator::set_phase_deviation(phase_deviation);
+            }
+        }
+        return restored;
     }
+}
 
-    void DCF77_No_Frequency_Control::process_1_Hz_tick(const DCF77_Encoder &decoded_time) {}
+namespace Internal {  // DCF77_No_Frequency_Control
+    bool DCF77_No_Frequency_Control::process_1_Hz_tick(const DCF77_Encoder &decoded_time) { return false; }
     void DCF77_No_Frequency_Control::process_1_kHz_tick() {}
+    void DCF77_No_Frequency_Control::process_1_kHz_ticks(const uint16_t /* ticks */) {}
     void DCF77_No_Frequency_Control::qualify_calibration() {}
     void DCF77_No_Frequency_Control::unqualify_calibration() {}
     void DCF77_No_Frequency_Control::setup() {}
@@ -1666,22 +1850,36 @@ namespace Internal {
             return 0;
         }
 
+        // This is the only remaining dependency to the DCF77 clock.
+        // The implementation of the generator is otherwise completely generic.
+        using DCF77_Clock::the_clock_controller;
+
         static Clock::input_provider_t the_input_provider = zero_provider;
-        static int16_t adjust_pp16m = 0;
         static int32_t cumulated_phase_deviation = 0;
 
         void adjust(const int16_t pp16m) {
-            CRITICAL_SECTION {
-                // positive_value --> increase frequency
-                adjust_pp16m = pp16m;
-            }
+            the_clock_controller.Frequency_Control.set_adjustment(pp16m);
         }
 
         int16_t read_adjustment() {
-            // positive_value --> increase frequency
-            CRITICAL_SECTION {
-                const int16_t pp16m = adjust_pp16m;
-                return pp16m;
+            return the_clock_controller.Frequency_Control.read_adjustment();
+        }
+
+        int32_t read_phase_deviation() {
+            return cumulated_phase_deviation;
+        }
+
+        void set_phase_deviation(const int32_t phase_deviation) {
+            cumulated_phase_deviation = phase_deviation;
+        }
+
+        void process_sample(const uint8_t sample) {
+            if (Configuration::deferred_processing) {
+                // the decoders will run in DCF77_Clock::poll()
+                DCF77_Clock::the_sample_queue.push(sample);
+            } else {
+                the_clock_controller.process_1_kHz_tick_data(sample);
+                DCF77_Clock::process_timers();
             }
         }
 
@@ -1731,7 +1929,7 @@ namespace Internal {
         }
 
         void isr_handler() {
-            cumulated_phase_deviation += adjust_pp16m;
+            cumulated_phase_deviation += the_clock_controller.Frequency_Control.adjust_pp16m;
             // 250 / 16 000 000 = 1 / 64 000
             if (cumulated_phase_deviation >= inverse_timer_resolution) {
                 cumulated_phase_deviation -= inverse_timer_resolution;
@@ -1748,7 +1946,7 @@ namespace Internal {
                 OCR2A = OCR2A_standard;
             }
 
-            Clock_Controller::process_1_kHz_tick_data(the_input_provider());
+            process_sample(the_input_provider());
             #if F_CPU == 8000000L
             // if we are running @ 8Mhz, sample twice per period to achieve
             // 1 kHz sampling rate. Of course the samples wil not be evenly spaced.
@@ -1762,7 +1960,7 @@ namespace Internal {
             // do not rely on evenly spaced ticks. It also implies that
             // the code changes for the 8 MHz version are minimized and thus
             // the potential for introducing bugs is lower.
-            Clock_Controller::process_1_kHz_tick_data(the_input_provider());
+            process_sample(the_input_provider());
             #endif
         }
         #endif
@@ -1793,7 +1991,7 @@ namespace Internal {
         }
 
         void isr_handler() {
-            cumulated_phase_deviation += adjust_pp16m;
+            cumulated_phase_deviation += the_clock_controller.Frequency_Control.adjust_pp16m;
             // 1 / 250 / 64000 = 1 / 16 000 000
             if (cumulated_phase_deviation >= 64000) {
                 cumulated_phase_deviation -= 64000;
@@ -1811,7 +2009,7 @@ namespace Internal {
                 OCR3A = 249;
             }
 
-            Clock_Controller::process_1_kHz_tick_data(the_input_provider());
+            process_sample(the_input_provider());
         }
         #endif
 
@@ -1827,7 +2025,7 @@ namespace Internal {
         const uint16_t inverse_timer_resolution = 16000;
 
         void isr_handler() {
-            cumulated_phase_deviation += adjust_pp16m;
+            cumulated_phase_deviation += the_clock_controller.Frequency_Control.adjust_pp16m;
             if (cumulated_phase_deviation >= inverse_timer_resolution) {
                 cumulated_phase_deviation -= inverse_timer_resolution;
                 // cumulated drift exceeds microsecond)
@@ -1842,7 +2040,7 @@ namespace Internal {
                 SysTick->LOAD = ticks_per_ms;
             }
 
-            Clock_Controller::process_1_kHz_tick_data(the_input_provider());
+            process_sample(the_input_provider());
         }
         #endif
 
@@ -1858,7 +2056,7 @@ namespace Internal {
         const uint16_t inverse_timer_resolution = 16000;
 
         void isr_handler() {
-            cumulated_phase_deviation += adjust_pp16m;
+            cumulated_phase_deviation += the_clock_controller.Frequency_Control.adjust_pp16m;
             if (cumulated_phase_deviation >= inverse_timer_resolution) {
                 cumulated_phase_deviation -= inverse_timer_resolution;
                 // cumulated drift exceeds microsecond)
@@ -1873,7 +2071,7 @@ namespace Internal {
                 systick_init(ticks_per_ms);
             }
 
-            Clock_Controller::process_1_kHz_tick_data(the_input_provider());
+            process_sample(the_input_provider());
         }
         #endif
     }
@@ -82,6 +82,39 @@ struct Configuration {
     static const bool want_high_phase_lock_resolution = true;
     //const bool want_high_phase_lock_resolution = false;
 
+    enum ticks_per_second_t : uint16_t { centi_seconds = 100, five_milli_seconds = 200, four_milli_seconds = 250,
+                                         two_milli_seconds = 500, milli_seconds = 1000 };
+
+    // The resolution that is used if milli_seconds is not wanted or not possible.
+    // The intermediate resolutions trade RAM against phase accuracy and auto tune
+    // settling time. The demodulator needs 2 bytes per bin, e.g. 200 bytes for
+    // centi_seconds and 1000 bytes for two_milli_seconds. A finer phase catches
+    // up with the drift of the local clock earlier, hence the local clock may
+    // skip or repeat a second at another moment than with centi_seconds. The
+    // frequency control measures with the same resolution, thus tau_min and
+    // the deviation that triggers a readjustment are shorter.
+    static const ticks_per_second_t low_phase_lock_resolution = centi_seconds;
+
+    // Only relevant if the resolution does not end up as milli_seconds, e.g. on AVR.
+    // Setting this to true will acquire the phase with the 100 bins as usual
+    // but then track it with a narrow window of 32 bins of 1 ms each around
+    // the phase of the 100 bins. This gives millisecond phase accuracy and the
+    // faster auto tune of the milli_seconds resolution for about 70 bytes of RAM.
+    // Just like milli_seconds it is pointless without a crystal.
+    static const bool want_fine_phase_tracking = false;
+
+    // Only relevant if the resolution ends up as milli_seconds. Setting this to
+    // true stores the 1000 phase bins of the demodulator with 8 instead of 16 bits.
+    // This saves 1 KB of RAM. Once the clock is tuned the bins saturate at half
+    // the level, thus the demodulator follows phase drift twice as fast. The
+    // price is accuracy: the phase is averaged over half the time only, hence it
+    // is noisier and the local clock corrects its phase at other moments. The
+    // decoded time is the same, but in the regression corpus the local clock
+    // skips a second to catch up with the drift of a log about 40 s earlier.
+    // With compact bins AVRs with at least 8 KB of RAM (e.g. the ATmega2560)
+    // are allowed to use milli_seconds.
+    static const bool want_compact_phase_bins = false;
+
     // end of configuration section, the stuff below
     // will compute the implications of the desired configuration,
     // ready for the compiler to consume
@@ -91,13 +124,25 @@ struct Configuration {
     static const bool has_lots_of_memory = false;
     #endif
 
+    #if defined(__AVR__) && defined(RAMEND) && (RAMEND >= 0x21FF)
+    static const bool has_8k_memory = true;
+    #else
+    static const bool has_8k_memory = false;
+    #endif
+
     static const bool high_phase_lock_resolution = want_high_phase_lock_resolution &&
-                                                   has_lots_of_memory;
+                                                   (has_lots_of_memory || (want_compact_phase_bins && has_8k_memory));
+
+    static const bool compact_phase_bins = want_compact_phase_bins && high_phase_lock_resolution;
 
-    enum ticks_per_second_t : uint16_t { centi_seconds = 100, milli_seconds = 1000 };
     // this is the actuall sample rate
     static const ticks_per_second_t phase_lock_resolution = high_phase_lock_resolution ? milli_seconds
-                                                                                       : centi_seconds;
+                                                                                       : low_phase_lock_resolution;
+
+    static const bool fine_phase_tracking = want_fine_phase_tracking && phase_lock_resolution != milli_seconds;
+    // this is the resolution of the phase that drives the local clock and the frequency control
+    static const ticks_per_second_t phase_tracking_resolution = fine_phase_tracking ? milli_seconds
+                                                                                    : phase_lock_resolution;
 
     enum quality_factor_sync_threshold_t : uint8_t { aggressive_sync = 1, standard_sync = 2, conservative_sync = 3 };
     static const uint8_t quality_factor_sync_threshold = quality_factor_sync_threshold_t::aggressive_sync;
@@ -138,6 +183,34 @@ struct Configuration {
     // this is completely pointless in the presence of huge changes in ambient temperature.
     static const bool has_stable_ambient_temperature = true;     // indoor deployment
     // static const bool has_stable_ambient_temperature = false; // outdoor deployment
+
+    // Once per second a single 1 kHz tick runs the whole decoder cascade. This tick
+    // takes much longer than the others and thus jitters other interrupts.
+    // Set to true to spread the decoder cascade and the setup of the convolution
+    // kernel over the following ticks, one decoder per tick. The decoded time and
+    // the clock state are exactly the same. The price is about a dozen bytes of RAM
+    // and that the decoders' quality factors may lag behind by a few milliseconds.
+    static const bool amortize_1_Hz_work = false;
+
+    // Set to false if only the time of day is needed, e.g. for a wall clock
+    // without date display. Then the weekday, day, month and year decoders and
+    // their bins are left out and the sync quality depends only on the phase,
+    // second, minute and hour. This saves about 100 bytes of RAM and some cycles
+    // per second. The clock syncs as soon as the hour is locked, the date of
+    // the time it delivers stays undefined (0xff).
+    static const bool decode_date = true;
+
+    // By default the 1 kHz interrupt runs all of the decoders and the output handler.
+    // Set deferred_processing to true to take them out of the interrupt. Then the
+    // interrupt only samples the input and queues the samples. DCF77_Clock::poll()
+    // must be called from loop() to process them. The queue holds 8 samples per byte
+    // and one byte is always kept free. That is with 32 bytes poll() must be called
+    // at least every 248 ms. Otherwise samples are lost, see
+    // DCF77_Clock::get_lost_samples(). The queue size must be a power of 2.
+    // As poll() writes the time, the time must then be read from loop() only.
+    // An interrupt that reads it while poll() is writing would get a torn value.
+    static const bool deferred_processing = false;
+    static const uint8_t deferred_queue_bytes = 32;
 };
 
 // https://gcc.gnu.org/onlinedocs/cpp/Stringizing.html
@@ -253,6 +326,21 @@ namespace Clock {
         locked   = 4,  // clock driven by accurate phase, time is accurate but not all decoder stages have sufficient quality for sync
         synced   = 5   // best possible quality, clock is 100% synced
     } clock_state_t;
+
+    // will be called from within the 1 kHz interrupt, keep it short
+    typedef void (*timer_action_t)(void);
+
+    // Timer for DCF77_Clock::schedule. The library links the timers into its
+    // timer wheel. Hence a timer must stay alive until it fired or until it
+    // was cancelled. Its members are managed by the library.
+    struct timer_t {
+        timer_t *prev = 0;
+        timer_t *next = 0;
+        uint64_t instant = 0;
+        uint16_t millisecond = 0;
+        timer_action_t action = 0;
+        volatile uint8_t slot = 0xff;  // 0xff --> not armed
+    };
 }
 
 namespace DCF77_Clock {
@@ -262,10 +350,27 @@ namespace DCF77_Clock {
     void set_input_provider(const Clock::input_provider_t);
     void set_output_handler(const Clock::output_handler_t output_handler);
 
+    // With Configuration::deferred_processing the functions that read the time
+    // must be called from loop() only, they are not interrupt safe in this mode.
+
     // blocking till start of next second
+    // With Configuration::deferred_processing it calls poll() until the next
+    // second starts. Called from an interrupt or before the 1 kHz generator
+    // runs, i.e. before setup(), it never returns. Call it from loop() only.
     void get_current_time(Clock::time_t &now);
-    // non-blocking, reads current second
+    // non-blocking version of get_current_time, returns true once per second
+    // at the start of the second, otherwise false and now is not touched
+    bool try_get_current_time(Clock::time_t &now);
+    // non-blocking, lock free, reads current second
     void read_current_time(Clock::time_t &now);
+    // non-blocking, lock free, reads current second and the milliseconds
+    // since the start of this second (0..999)
+    void read_current_time(Clock::time_t &now, uint16_t &millisecond);
+    // Milliseconds since setup. The counter is driven by the same disciplined
+    // 1 kHz ticks as the local clock. Unlike the time it will never jump, not
+    // even on resync. Thus it is a better choice than millis() for timestamps.
+    // Notice that on AVR millis() is stopped by the library anyway.
+    uint64_t get_monotonic_milliseconds();
     // non-blocking, reads current second+1
     void read_future_time(Clock::time_t &now_plus_1s);
 
@@ -276,6 +381,19 @@ namespace DCF77_Clock {
 
     void debug();
 
+    // Calls action from within the 1 kHz interrupt as soon as the local clock
+    // reaches time + millisecond. The time must be local time, uses_summertime
+    // tells apart the hour that occurs twice when summer time ends. Times that
+    // are skipped (summer time starts, the clock jumps on resync) fire as soon
+    // as they are passed. Timers do not fire while the clock state is useless or
+    // dirty, they fire late once the clock is good enough again. Scheduling and
+    // cancelling are O(1). Scheduling an armed timer moves it.
+    void schedule(Clock::timer_t &timer, const Clock::time_t &time, const uint16_t millisecond,
+                  const Clock::timer_action_t action);
+    // does nothing if the timer is not armed
+    void cancel(Clock::timer_t &timer);
+    bool is_armed(const Clock::timer_t &timer);
+
     // determine quality of the DCF77 signal lock
     uint8_t get_overall_quality_factor();
 
@@ -289,6 +407,24 @@ namespace DCF77_Clock {
     // 26 = very poor
     // 50 = best possible, every signal bit matches with the local clock
     uint8_t get_prediction_match();
+
+    // Snapshots of the complete clock state including the phase of the 1 kHz
+    // generator, e.g. to fork simulations or to survive a reset. A snapshot
+    // can only be restored by the very same build of the library.
+    // restore_snapshot will return false if the snapshot does not fit.
+    uint16_t get_snapshot_size();
+    void save_snapshot(uint8_t *snapshot);
+    bool restore_snapshot(const uint8_t *snapshot);
+
+    // Only required for Configuration::deferred_processing, otherwise it does nothing.
+    // Processes the samples queued by the 1 kHz interrupt. Thus the output handler
+    // is called from poll(). The clock advances only while polling, i.e. the current
+    // time lags behind by the samples that are still queued.
+    void poll();
+    // number of samples that were dropped because the queue was full
+    uint32_t get_lost_samples();
+    // the highest number of queued samples so far, use it to size the queue
+    uint16_t get_max_queued_samples();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -308,6 +444,7 @@ namespace Internal {
         void bcddigit(uint8_t data);
         void bcddigits(uint8_t data);
         void hexdump(uint8_t data);
+        void sprintpp16m(int16_t pp16m);
     }
 
     namespace DCF77 {
@@ -328,6 +465,15 @@ namespace Internal {
         } serialized_clock_stream;
     }
 
+    // Constant tables go to the flash on AVR. Elsewhere const data does not take RAM anyway.
+    #if defined(__AVR__)
+        #define DCF77_PROGMEM PROGMEM
+        #define DCF77_READ_PROGMEM_BYTE(address) pgm_read_byte(address)
+    #else
+        #define DCF77_PROGMEM
+        #define DCF77_READ_PROGMEM_BYTE(address) (*(address))
+    #endif
+
     namespace TMP {
         // determine type depending on number of bits
         template <uint8_t typesize> struct uint_t {};
@@ -353,6 +499,21 @@ namespace Internal {
 
         template <bool condition, typename x, typename y> struct if_t             { typedef y type; };
         template <                typename x, typename y> struct if_t<true, x, y> { typedef x type; };
+
+        // table_t<generator_t, count>::data[i] == generator_t::value(i) for i < count,
+        // computed at compile time. The table is placed in DCF77_PROGMEM.
+        template <uint8_t... values>
+        struct table_data_t {
+            static const uint8_t data[sizeof...(values)];
+        };
+        template <uint8_t... values>
+        const uint8_t table_data_t<values...>::data[sizeof...(values)] DCF77_PROGMEM = { values... };
+
+        template <typename generator_t, uint8_t count, uint8_t... values>
+        struct table_t : table_t<generator_t, count-1, generator_t::value(count-1), values...> {};
+
+        template <typename generator_t, uint8_t... values>
+        struct table_t<generator_t, 0, values...> : table_data_t<values...> {};
     }
 
     namespace Arithmetic_Tools {
@@ -526,6 +687,7 @@ namespace Internal {
     #if defined(__AVR__)
         #include <util/atomic.h>
         #define CRITICAL_SECTION ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        #define MEMORY_BARRIER asm volatile ("" ::: "memory")
 
     #elif defined(__arm__)
         // Workaround as suggested by Stackoverflow user "Notlikethat"
@@ -548,11 +710,14 @@ namespace Internal {
         // avr-libc util/atomic.h
         // --> http://www.nongnu.org/avr-libc/user-manual/atomic_8h_source.html
         #define CRITICAL_SECTION for (int primask_save __attribute__((__cleanup__(__int_restore_irq))) = __int_disable_irq(), __n = 1; __n; __n = 0)
+        // single core, hence a compiler barrier is sufficient
+        #define MEMORY_BARRIER asm volatile ("" ::: "memory")
 
     #elif defined(__unix__) && defined(__unit_test__)
         #warning Compiling for Linux target only supported for unit test purposes. Only fake support for atomic sections. Please take care.
 
         #define CRITICAL_SECTION for (int __n = 1; __n; __n = 0)
+        #define MEMORY_BARRIER asm volatile ("" ::: "memory")
     #else
         #error Unsupported controller architecture
     #endif
@@ -566,6 +731,13 @@ namespace Internal {
         #define sprintln(...) Serial.println(__VA_ARGS__)
     #endif
 
+    // Hook for the tick latency profiler of the standalone debug helper. It marks
+    // that one of the expensive paths of the clock controller ran during the
+    // current 1 kHz tick. Unless the profiler defines it, it expands to nothing.
+    #if !defined(DCF77_MARK_TICK_PATH)
+        #define DCF77_MARK_TICK_PATH(path)
+    #endif
+
     namespace Binning {
         template <typename uint_t>
         struct lock_quality_tt {
@@ -604,6 +776,12 @@ namespace Internal {
             noise_type signal_max;
             index_t    signal_max_index;
 
+            // The quality factor depends on signal_max and noise_max only. Thus
+            // it is cached and recomputed only after one of them has changed.
+            noise_type cached_noise_max;
+            noise_type cached_signal_max;
+            uint8_t    cached_quality_factor;
+
             void setup() {
                 for (index_t index = 0; index < number_of_bins; ++index) {
                     data[index] = 0;
@@ -613,6 +791,11 @@ namespace Internal {
                 signal_max = 0;
                 signal_max_index = number_of_bins + 1;
                 noise_max = 0;
+
+                // matches compute_quality_factor(0, 0)
+                cached_noise_max = 0;
+                cached_signal_max = 0;
+                cached_quality_factor = 0;
             }
 
             void advance_tick() {
@@ -632,17 +815,34 @@ namespace Internal {
 
             uint8_t get_quality_factor() {
                 noise_type signal_max;
-                noise_type delta;
+                noise_type noise_max;
 
                 CRITICAL_SECTION {
                     signal_max = this->signal_max;
+                    noise_max = this->noise_max;
 
-                    if (signal_max <= this->noise_max) {
-                        return 0;
+                    if (signal_max == cached_signal_max && noise_max == cached_noise_max) {
+                        return cached_quality_factor;
                     }
-                    delta = signal_max - this->noise_max;
                 }
 
+                const uint8_t quality_factor = compute_quality_factor(signal_max, noise_max);
+
+                // the cache entry must be consistent even if an interrupt also computes it
+                CRITICAL_SECTION {
+                    cached_signal_max = signal_max;
+                    cached_noise_max = noise_max;
+                    cached_quality_factor = quality_factor;
+                }
+                return quality_factor;
+            }
+
+            static uint8_t compute_quality_factor(noise_type signal_max, const noise_type noise_max) {
+                if (signal_max <= noise_max) {
+                    return 0;
+                }
+                noise_type delta = signal_max - noise_max;
+
                 if (TMP::equal<noise_type, uint32_t>::val) {
                     // noise_type equals uint32_t --> typically convolution and other integration style stuff
                     uint8_t log2_plus_1 = 0;
@@ -761,12 +961,59 @@ namespace Internal {
         };
 
 
+        // The candidates of the BCD decoders as bit masks. The low bits hold
+        // the BCD value of the candidate. If the decoder has a parity bit
+        // it is placed right above the significant bits. Thus the expected
+        // bit for any bit position is just one bit of the mask.
+        constexpr uint8_t bcd_parity(const uint8_t bcd) {
+            return bcd? (bcd & 1) ^ bcd_parity(bcd >> 1): 0;
+        }
+
+        constexpr uint8_t candidate_bits(const uint8_t value, const uint8_t significant_bits, const bool with_parity) {
+            return ((value / 10) << 4 | value % 10) |
+                   (with_parity? bcd_parity((value / 10) << 4 | value % 10) << significant_bits: 0);
+        }
+
+        // A BCD decoder works in the seconds of its bits and in the following second.
+        // The latter publishes the maximum of the bins.
+        template <typename binning_t>
+        constexpr bool is_BCD_binning_second(const uint8_t second) {
+            return second >= binning_t::signal_bitno_offset &&
+                   second <= binning_t::signal_bitno_offset + binning_t::significant_bits + binning_t::with_parity;
+        }
+
+        // TMP::table_t<candidate_generator_t<first_value, ...>, n>::data[pass] holds the mask for the candidate first_value+pass
+        template <uint8_t first_value, uint8_t significant_bits, bool with_parity>
+        struct candidate_generator_t {
+            static constexpr uint8_t value(const uint8_t pass) {
+                return candidate_bits(first_value + pass, significant_bits, with_parity);
+            }
+        };
+
         template <typename data_type, uint16_t number_of_bins>
         struct Decoder : bins_t<data_type, data_type, number_of_bins> {
             typedef data_type data_t;
             typedef typename bins_t<data_t, data_t, number_of_bins>::index_t index_t;
 
+            // The maximum of the bins as determined while binning the last bit.
+            // It is published one second later, that is when compute_max_index
+            // used to scan the bins.
+            data_t  pending_signal_max;
+            data_t  pending_noise_max;
+            index_t pending_signal_max_index;
+
+            void setup() {
+                bins_t<data_t, data_t, number_of_bins>::setup();
+
+                // what compute_max_index would find in the empty bins
+                pending_signal_max = 0;
+                pending_noise_max = 0;
+                pending_signal_max_index = number_of_bins - 1;
+            }
+
             void compute_max_index() {
+                DCF77_MARK_TICK_PATH(compute_max_index);
+
                 this->noise_max = 0;
                 this->signal_max = 0;
                 this->signal_max_index = number_of_bins + 1;
@@ -834,16 +1081,34 @@ namespace Internal {
 
                 const uint8_t number_of_bits = significant_bits + with_parity;
                 if (bitno > number_of_bits) { return; }
-                if (bitno == number_of_bits) { compute_max_index(); return; }
+                if (bitno == number_of_bits) {
+                    this->signal_max = pending_signal_max;
+                    this->noise_max = pending_noise_max;
+                    this->signal_max_index = pending_signal_max_index;
+                    return;
+                }
 
                 const data_t upper_bin_bound = TMP::equal<data_t, uint8_t>::val? 255 : (60 * number_of_bits * signal_max) / 2;
 
                 // for minutes, hours have parity and start counting at 0
                 // for days, weeks, month we have no parity and start counting at 1
                 // for years and decades we have no parity and start counting at 0
-                // TODO: more explicit offset handling
-                bcd_t candidate;
-                candidate.val = (with_parity || number_of_bins == 10)? 0x00: 0x01;
+                typedef TMP::table_t<candidate_generator_t<(with_parity || number_of_bins == 10)? 0x00: 0x01,
+                                                           significant_bits, with_parity>,
+                                     number_of_bins> candidates;
+                // the parity bit is right above the significant bits
+                const uint8_t bit_mask = 1 << bitno;
+
+                // The last bit of the decoder also determines the maximum of the bins,
+                // hence there is no separate pass of compute_max_index. Ties go to the
+                // higher index, just like in compute_max_index. The bins are scaled
+                // afterwards, but this preserves their order.
+                const bool is_last_bit = (bitno == number_of_bits-1);
+                if (is_last_bit) { DCF77_MARK_TICK_PATH(compute_max_index); }
+                data_t  top = 0;
+                data_t  runner_up = 0;
+                index_t top_index = 0;
+
                 data_t min = upper_bin_bound;
                 data_t max = 0;
 
@@ -851,29 +1116,33 @@ namespace Internal {
                 index_t bin_index = offset;
                 for (index_t pass=0; pass < number_of_bins; ++pass) {
                     data_t& current_bin = this->data[bin_index];
-                    if (bitno < significant_bits) {
-                        // score vs. bcd value determined by pass
-                        score<data_t, signal_t, signal_max>(current_bin, signal, (candidate.val >> bitno) & 1);
-                    } else
-                    if (with_parity) {
-                        if (bitno == significant_bits) {
-                            // score vs. parity bit
-                            score<data_t, signal_t, signal_max>(current_bin, signal, parity(candidate.val));
-                        }
-                    }
+                    // score vs. bcd value or parity determined by pass
+                    score<data_t, signal_t, signal_max>(current_bin, signal,
+                                                        DCF77_READ_PROGMEM_BYTE(&candidates::data[pass]) & bit_mask);
 
                     maximize(max, current_bin);
                     minimize(min, current_bin);
 
+                    if (is_last_bit) {
+                        if (current_bin > top || (current_bin == top && bin_index > top_index)) {
+                            runner_up = top;
+                            top = current_bin;
+                            top_index = bin_index;
+                        } else if (current_bin > runner_up) {
+                            runner_up = current_bin;
+                        }
+                    }
+
                     bin_index = bin_index < number_of_bins-1? bin_index+1: 0;
-                    increment(candidate);
                 }
 
-                if (max - min <= upper_bin_bound) {
+                if (min > 0 && max - min <= upper_bin_bound) {
                     // enforce min == 0, upper bound will be fine anyway
                     for (index_t pass=0; pass < number_of_bins; ++pass) {
                         this->data[pass] -= min;
                     }
+                    top -= min;
+                    runner_up -= min;
                 }
 
                 if (max >= upper_bin_bound - number_of_bits) {
@@ -886,6 +1155,18 @@ namespace Internal {
                         bounded_decrement<number_of_bits>(current_bin);
                         maximize(current_bin, (data_t) 0);
                     }
+                    bounded_decrement<number_of_bits>(top);
+                    bounded_decrement<number_of_bits>(runner_up);
+                    if (top == 0) {
+                        // all bins are 0 now
+                        top_index = number_of_bins-1;
+                    }
+                }
+
+                if (is_last_bit) {
+                    pending_signal_max = top;
+                    pending_noise_max = runner_up;
+                    pending_signal_max_index = top_index;
                 }
             }
         };
@@ -941,23 +1222,32 @@ namespace Internal {
         };
     }
 
+    template <typename Configuration>
+    struct DCF77_Phase_Bins {
+        // Configuration::compact_phase_bins --> 8 bit bins
+        typedef Binning::Convoluter<typename TMP::if_t<Configuration::compact_phase_bins, uint8_t, uint16_t>::type,
+                                    Configuration::phase_lock_resolution> type;
+    };
+
     template <typename Clock_Controller>
-    struct DCF77_Demodulator : Binning::Convoluter<uint16_t, Clock_Controller::Configuration::phase_lock_resolution> {
-        typedef typename Binning::Convoluter<uint16_t, Clock_Controller::Configuration::phase_lock_resolution>::index_t index_t;
-        typedef typename Binning::Convoluter<uint16_t, Clock_Controller::Configuration::phase_lock_resolution>::data_t data_t;
+    struct DCF77_Demodulator : DCF77_Phase_Bins<typename Clock_Controller::Configuration>::type {
+        typedef typename DCF77_Phase_Bins<typename Clock_Controller::Configuration>::type Phase_Bins;
+        typedef typename Phase_Bins::index_t index_t;
+        typedef typename Phase_Bins::data_t data_t;
 
         static const index_t bin_count = Clock_Controller::Configuration::phase_lock_resolution;
         static const uint16_t samples_per_second = 1000;
 
         static const uint16_t samples_per_bin = samples_per_second / bin_count;
-        static const uint16_t bins_per_10ms  = bin_count / 100;
-        static const uint16_t bins_per_50ms  =  5 * bins_per_10ms;
-        static const uint16_t bins_per_60ms  =  6 * bins_per_10ms;
-        static const uint16_t bins_per_100ms = 10 * bins_per_10ms;
-        static const uint16_t bins_per_200ms = 20 * bins_per_10ms;
-        static const uint16_t bins_per_400ms = 40 * bins_per_10ms;
-        static const uint16_t bins_per_500ms = 50 * bins_per_10ms;
-        static const uint16_t bins_per_600ms = 60 * bins_per_10ms;
+        // bin_count / 100 would be 2 for 250 bins, thus each is computed directly
+        static const uint16_t bins_per_10ms  =  10 * bin_count / samples_per_second;
+        static const uint16_t bins_per_50ms  =  50 * bin_count / samples_per_second;
+        static const uint16_t bins_per_60ms  =  60 * bin_count / samples_per_second;
+        static const uint16_t bins_per_100ms = 100 * bin_count / samples_per_second;
+        static const uint16_t bins_per_200ms = 200 * bin_count / samples_per_second;
+        static const uint16_t bins_per_400ms = 400 * bin_count / samples_per_second;
+        static const uint16_t bins_per_500ms = 500 * bin_count / samples_per_second;
+        static const uint16_t bins_per_600ms = 600 * bin_count / samples_per_second;
 
         static uint16_t wrap(const uint16_t value) {
             // faster modulo function which avoids division
@@ -982,13 +1272,27 @@ namespace Internal {
         // This is because otherwise we will not be able to deal with noise
         // in any reasonable way.
         uint16_t N = ticks_to_drift_one_tick / bin_count;
+
+        // 8 bit bins can not hold N = 300 (tuned, 1000 bins). Thus the bins
+        // saturate at N / bin_scale and the maxima of the integral are scaled
+        // back by bin_scale. For 16 bit bins bin_scale is always 1.
+        uint8_t bin_scale = 1;
+        void set_saturation(const uint32_t ticks_to_drift) {
+            N = ticks_to_drift / bin_count;
+            bin_scale = 1;
+            while (N / bin_scale > (data_t)-1) {
+                ++bin_scale;
+            }
+            N /= bin_scale;
+        }
+
         void reset_has_tuned_clock() {
             // will be called once crystal is tuned to better than 1 ppm.
-            N = ticks_to_drift_one_tick / bin_count;
+            set_saturation(ticks_to_drift_one_tick);
         }
         void set_has_tuned_clock() {
             // will be called once crystal is tuned to better than 1 ppm.
-            N = tuned_ticks_to_drift_one_tick / bin_count;
+            set_saturation(tuned_ticks_to_drift_one_tick);
         }
 
         int32_t integral = 0;
@@ -996,18 +1300,150 @@ namespace Internal {
         index_t running_max_index = 0;
         int32_t running_noise_max = 0;
 
+        // Fine phase tracking (Configuration::fine_phase_tracking)
+        //
+        // The bins locate the start of the second mark only up to samples_per_bin
+        // milliseconds. Thus a window of 1 ms bins is kept around the start of the
+        // second mark as found by signal_max_index. The fine bins are filtered just
+        // like the coarse bins. Once per period a step kernel locates the start of
+        // the second mark within the window. The flush is triggered one bin earlier
+        // than usual and then delayed by the proper number of samples. Until the
+        // window has a clear step the delay is one bin, i.e. the flush happens
+        // exactly when it would without fine tracking.
+        static const bool fine_phase_tracking = Clock_Controller::Configuration::fine_phase_tracking && samples_per_bin > 1;
+
+        struct fine_tracker_t {
+            static const uint8_t fine_bin_count = 32;
+
+            data_t   data[fine_bin_count];
+            uint16_t window_start;  // position of data[0], 0..999 ms
+            uint16_t edge;          // start of the second mark, 0..999 ms
+            bool     edge_valid;
+            uint8_t  flush_countdown;  // 0 --> no flush pending
+
+            static uint16_t wrap_ms(const uint16_t value) {
+                return value < samples_per_second? value: value - samples_per_second;
+            }
+
+            void clear_window(const uint16_t start) {
+                for (uint8_t bin = 0; bin < fine_bin_count; ++bin) {
+                    data[bin] = 0;
+                }
+                window_start = start;
+                edge = 0;
+                edge_valid = false;
+            }
+
+            void setup() {
+                clear_window(0);
+                flush_countdown = 0;
+            }
+
+            // bin is the bin that is currently filled by stage
+            template <typename stage_t>
+            void process_sample(const index_t bin, const stage_t &stage, const uint8_t sampled_data, const data_t n) {
+                const uint16_t position = bin * samples_per_bin + stage.sample_count;
+                const uint16_t offset = wrap_ms(samples_per_second + position - window_start);
+                if (offset < fine_bin_count) {
+                    data_t &current = data[offset];
+                    if (current > n) { current = n; }
+                    if (sampled_data) {
+                        if (current < n) { ++current; }
+                    } else {
+                        if (current > 0) { --current; }
+                    }
+                }
+            }
+
+            // called once per period right after signal_max_index was updated
+            void process_period(const uint16_t coarse_edge, const data_t n) {
+                const uint16_t desired_start = wrap_ms(samples_per_second + coarse_edge - fine_bin_count / 2);
+                const uint16_t shift = wrap_ms(samples_per_second + desired_start - window_start);
+                if (shift > samples_per_bin && shift < samples_per_second - samples_per_bin) {
+                    // The coarse phase moved by more than one bin. If it just toggles
+                    // between two neighbouring bins the window stays where it is.
+                    // A pending flush is not affected.
+                    clear_window(desired_start);
+                    return;
+                }
+
+                // Step kernel, -1 before the offset and +1 from the offset on. The bins
+                // are taken relative to n/2, thus the kernel peaks at the step.
+                int32_t step = 0;
+                for (uint8_t bin = 0; bin < fine_bin_count; ++bin) {
+                    step += 2 * (int32_t)data[bin] - n;
+                }
+                int32_t best_step = step;
+                uint8_t best_offset = 0;
+                for (uint8_t offset = 1; offset < fine_bin_count; ++offset) {
+                    step -= 2 * (2 * (int32_t)data[offset - 1] - n);
+                    if (step > best_step) {
+                        best_step = step;
+                        best_offset = offset;
+                    }
+                }
+
+                // A clean step in the middle of the window yields n * fine_bin_count.
+                // If the best step is at the very start of the window there is no step.
+                edge_valid = best_offset > 0 && best_step > (int32_t)n * (fine_bin_count / 4);
+                edge = wrap_ms(window_start + best_offset);
+            }
+
+            // Called at the trigger, position is the position of the next sample.
+            // Schedules the flush right before the start of the second mark.
+            void trigger(const uint16_t position, const uint16_t coarse_edge) {
+                const uint16_t target = edge_valid? edge: coarse_edge;
+                uint16_t delay = wrap_ms(samples_per_second + target - position);
+                if (delay > samples_per_second / 2) {
+                    // the start of the second mark is already behind us
+                    delay = 0;
+                } else if (delay > 2 * samples_per_bin + fine_bin_count / 2) {
+                    // at most up to the end of the window
+                    delay = 2 * samples_per_bin + fine_bin_count / 2;
+                }
+                // the countdown will be decremented once more at the end of the current sample
+                flush_countdown = delay + 1;
+            }
+
+            // called at the end of each sample, returns true if it is time to flush
+            bool flush_due() {
+                return flush_countdown > 0 && --flush_countdown == 0;
+            }
+
+            void debug() {
+                sprint(F("Fine phase: "));
+                sprint(window_start);
+                sprint(F(", edge: "));
+                sprint(edge);
+                sprintln(edge_valid? F(" valid"): F(" invalid"));
+            }
+        };
+
+        struct no_fine_tracker_t {
+            void setup() const {}
+            template <typename stage_t>
+            void process_sample(const index_t /* bin */, const stage_t & /* stage */, const uint8_t /* sampled_data */, const data_t /* n */) const {}
+            void process_period(const uint16_t /* coarse_edge */, const data_t /* n */) const {}
+            void trigger(const uint16_t /* position */, const uint16_t /* coarse_edge */) const {}
+            bool flush_due() const { return false; }
+            void debug() const {}
+        };
+
+        typename TMP::if_t<fine_phase_tracking, fine_tracker_t, no_fine_tracker_t>::type fine_tracker;
+
         void setup() {
-            Binning::Convoluter<uint16_t, Clock_Controller::Configuration::phase_lock_resolution>::setup();
+            Phase_Bins::setup();
             integral = 0;
             running_max = 0;
             running_max_index = 0;
             running_noise_max = 0;
-            N = ticks_to_drift_one_tick / bin_count;
+            set_saturation(ticks_to_drift_one_tick);
+            fine_tracker.setup();
         }
 
         void phase_binning(const uint8_t input)
                 __attribute__((always_inline)) {
-            Binning::Convoluter<uint16_t, Clock_Controller::Configuration::phase_lock_resolution>::advance_tick();
+            Phase_Bins::advance_tick();
             const index_t tick = this->tick;
 
             data_t & data = this->data[tick];
@@ -1042,9 +1478,9 @@ namespace Internal {
                 if (tick == 0) {
                     // one period has passed, flush the result
 
-                    this->signal_max       = running_max;
+                    this->signal_max       = running_max * bin_scale;
                     this->signal_max_index = running_max_index;
-                    this->noise_max        = running_noise_max;
+                    this->noise_max        = running_noise_max * bin_scale;
 
                     // reset running_max for next period
                     running_max = 0;
@@ -1062,7 +1498,7 @@ namespace Internal {
 
         typename TMP::uval_t<bin_count>::type count = 0;
         uint8_t decoded_data = 0;
-        void decode_200ms(const uint8_t input, const uint8_t bins_to_go) {
+        void decode_200ms(Clock_Controller &clock_controller, const uint8_t input, const uint8_t bins_to_go) {
             count += input;
             // will be called for each bin during the "interesting" 200 ms
             if (bins_to_go == bins_per_100ms + 1) {
@@ -1077,21 +1513,31 @@ namespace Internal {
                 //               2 --> 0,
                 //               1 --> undefined,
                 //               0 --> sync_mark
-                Clock_Controller::process_single_tick_data((DCF77::tick_t) decoded_data);
+                clock_controller.process_single_tick_data((DCF77::tick_t) decoded_data);
             }
         }
 
-        typename TMP::uval_t<bins_per_200ms+2>::type bins_to_go = 0;
-        void detector_stage_2(const uint8_t input) {
+        typename TMP::uval_t<bins_per_200ms+3>::type bins_to_go = 0;
+        void detector_stage_2(Clock_Controller &clock_controller, const uint8_t input) {
             const index_t current_bin = this->tick;
             if (bins_to_go == 0) {
                 if (wrap((bin_count + current_bin + 1 - this->signal_max_index)) <= bins_per_100ms ||   // current_bin at most 100ms after phase_bin
                     wrap((bin_count + this->signal_max_index - current_bin)) <= 1                  ) {  // current bin at most 1 tick before phase_bin
                     // if phase bin varies to much during one period we will always be screwed in may ways...
                     // last tick of current second
-                    Clock_Controller::flush();
+                    if (fine_phase_tracking) {
+                        fine_tracker.trigger(wrap(current_bin + 1) * samples_per_bin, this->signal_max_index * samples_per_bin);
+                    } else {
+                        clock_controller.flush();
+                    }
                     // start processing of bins
                     bins_to_go = bins_per_200ms + 2;
+                } else if (fine_phase_tracking && current_bin == wrap(bin_count + this->signal_max_index - 2)) {
+                    // The start of the second mark may be up to one bin before
+                    // signal_max_index. Hence the flush is scheduled one bin earlier.
+                    fine_tracker.trigger(wrap(current_bin + 1) * samples_per_bin, this->signal_max_index * samples_per_bin);
+                    // one more bin to go, the extra bin is not decoded
+                    bins_to_go = bins_per_200ms + 3;
                 }
             }
 
@@ -1100,7 +1546,9 @@ namespace Internal {
 
                 // this will be called for each bin in the "interesting" 200ms
                 // this is also a good place for a "monitoring hook"
-                decode_200ms(input, bins_to_go);
+                if (bins_to_go <= bins_per_200ms + 1) {
+                    decode_200ms(clock_controller, input, bins_to_go);
+                }
             }
         }
 
@@ -1108,6 +1556,11 @@ namespace Internal {
         // "with averages" case. However the straighforward approach leads to lots of nasty
         // complications with template scoping. Hence detector_stage_1 is still a function
         // and detector dispatches.
+        // If we have an even number of samples per bin we will always have a bias.
+        // Thus the middle sample is counted twice in order to get rid of the bias.
+        // This improves noise tolerance significantly.
+        static const uint8_t duplicated_sample = samples_per_bin % 2 == 0? samples_per_bin / 2 - 1: samples_per_bin;
+
         struct stage_with_averages {
             uint8_t sample_count = 0;
             uint8_t sum = 0;
@@ -1116,14 +1569,25 @@ namespace Internal {
                 sample_count = 0;
                 sum = 0;
             }
+            bool is_empty() const __attribute__ ((always_inline)) {
+                return sample_count == 0;
+            }
             void reduce(const uint8_t sampled_data) __attribute__ ((always_inline)){
                 sum += sampled_data;
-                // If we have an even number of samples we will always have a bias.
-                // Thus we duplicate the 5th sample in order to get rid of the bias.
-                // This improves noise tolerance significantly.
-                if (sample_count == 4) { sum += sampled_data; }
+                // e.g. the 5th of 10 samples
+                if (sample_count == duplicated_sample) { sum += sampled_data; }
                 ++sample_count;
             }
+            // same as calling reduce(sampled_data) samples times
+            void reduce(const uint8_t sampled_data, const uint8_t samples) {
+                sum += sampled_data * samples;
+                if (sample_count <= duplicated_sample && duplicated_sample < sample_count + samples) { sum += sampled_data; }
+                sample_count += samples;
+            }
+            // samples up to but excluding the one that completes the bin
+            uint8_t samples_before_data_ready() const {
+                return samples_per_bin - 1 - sample_count;
+            }
             bool data_ready() const __attribute__ ((always_inline)) {
                 return sample_count >= samples_per_bin;
             }
@@ -1134,7 +1598,10 @@ namespace Internal {
 
         struct dummy_stage {
             void    reset()                            const {}
+            bool    is_empty()                         const { return true; }
             void    reduce(const uint8_t sampled_data) const {}
+            void    reduce(const uint8_t sampled_data, const uint8_t samples) const {}
+            uint8_t samples_before_data_ready()        const { return 0; }
             bool    data_ready()                       const {}
             uint8_t avg()                              const {}
         };
@@ -1142,9 +1609,11 @@ namespace Internal {
         static const bool requires_averages = samples_per_bin > 1;
         typename TMP::if_t<requires_averages, stage_with_averages, dummy_stage>::type stage_1;
 
-        void detector_stage_1(const uint8_t sampled_data)
+        void detector_stage_1(Clock_Controller &clock_controller, const uint8_t sampled_data)
              __attribute__((always_inline)) {
 
+            fine_tracker.process_sample(wrap(this->tick + 1), stage_1, sampled_data, N / samples_per_bin);
+
             stage_1.reduce(sampled_data);
             if (stage_1.data_ready()) {
                 // once all samples for the current bin are captured the bin gets updated
@@ -1152,26 +1621,279 @@ namespace Internal {
                 const uint8_t input = stage_1.avg();
 
                 phase_binning(input);
-                detector_stage_2(input);
+                if (this->tick == 0) {
+                    fine_tracker.process_period(this->signal_max_index * samples_per_bin, N / samples_per_bin);
+                }
+                detector_stage_2(clock_controller, input);
 
                 stage_1.reset();
             }
+
+            if (fine_tracker.flush_due()) {
+                clock_controller.flush();
+            }
         }
 
-        void detector(const uint8_t sampled_data) {
+        // The clock controller is passed down the call chain instead of being
+        // stored. This keeps the demodulator free of back pointers and thus
+        // allows any number of independent clock controllers.
+        void detector(Clock_Controller &clock_controller, const uint8_t sampled_data) {
             if (samples_per_bin > 1) {
                 // average samples
-                detector_stage_1(sampled_data);
+                detector_stage_1(clock_controller, sampled_data);
             } else {
                 // no averaging required
                 phase_binning(sampled_data);
-                detector_stage_2(sampled_data);
+                detector_stage_2(clock_controller, sampled_data);
+            }
+        }
+
+        // true if the next sample will be the first sample of a bin
+        // fine phase tracking needs each sample, thus it never starts a bin at once
+        bool is_at_bin_start() const {
+            return !fine_phase_tracking && stage_1.is_empty();
+        }
+
+        // Number of samples that detector_samples() may process, i.e. the samples of
+        // the current bin up to but excluding the one that completes the bin. These
+        // are only averaged. Fine phase tracking needs each sample, hence it is 0 then.
+        uint8_t samples_before_bin_end() const {
+            return fine_phase_tracking || stage_1.is_empty()? 0: stage_1.samples_before_data_ready();
+        }
+
+        // Same as calling detector() for each of the samples which all have the
+        // value sampled_data. samples must not exceed samples_before_bin_end().
+        void detector_samples(const uint8_t sampled_data, const uint8_t samples) {
+            stage_1.reduce(sampled_data, samples);
+        }
+
+        // Block counterpart of detector(). Processes all samples of one bin at once,
+        // the first sample in the least significant bit. Must only be called if
+        // is_at_bin_start(). The result is exactly the same as for calling detector()
+        // for each sample, including the duplicated sample of stage_with_averages.
+        void detector_bin(Clock_Controller &clock_controller, const uint16_t samples) {
+            const uint8_t sum = __builtin_popcount(samples) + (duplicated_sample < samples_per_bin? (samples >> duplicated_sample) & 1: 0);
+            const uint8_t input = sum > samples_per_bin / 2;
+
+            phase_binning(input);
+            detector_stage_2(clock_controller, input);
+        }
+
+        // The phase_binning_* functions below process the count bins starting at tick.
+        // The caller ensures that neither tick, ck_start_tick nor ck_middle_tick wrap
+        // and that the bins contain neither the wrap of the tick to 0 nor the bin
+        // where the noise is sampled. The result is exactly the same as for calling
+        // phase_binning(input) count times.
+
+        // bin by bin, just without recomputing the wrapped indices
+        void phase_binning_bins(const uint8_t input, const index_t tick,
+                                const index_t ck_start_tick, const index_t ck_middle_tick, const uint16_t count) {
+            // local copies, otherwise the compiler must assume that writing to data aliases them
+            data_t * const data = this->data;
+            const data_t n = N;
+            int32_t integral          = this->integral;
+            int32_t running_max       = this->running_max;
+            index_t running_max_index = this->running_max_index;
+
+            for (uint16_t bin = 0; bin < count; ++bin) {
+                data_t current = data[tick + bin];
+                if (current > n) {
+                    current = n;
+                }
+                if (input) {
+                    current += current < n;
+                } else {
+                    current -= current > 0;
+                }
+                data[tick + bin] = current;
+
+                if (integral > running_max) {
+                    running_max = integral;
+                    running_max_index = ck_start_tick + bin;
+                }
+
+                integral -= (int32_t)data[ck_start_tick + bin]*2;
+                integral += (int32_t)data[ck_middle_tick + bin];
+                integral += (int32_t)current;
+            }
+
+            this->tick              = tick + count - 1;
+            this->integral          = integral;
+            this->running_max       = running_max;
+            this->running_max_index = running_max_index;
+        }
+
+        // Number of bins, at most limit, for which the bins at tick, ck_start_tick and
+        // ck_middle_tick keep the value of their first bin.
+        uint16_t get_constant_bins(const index_t tick, const index_t ck_start_tick, const index_t ck_middle_tick,
+                                   const uint16_t limit) const {
+            const data_t * const data = this->data;
+            const data_t tick_value      = data[tick];
+            const data_t ck_start_value  = data[ck_start_tick];
+            const data_t ck_middle_value = data[ck_middle_tick];
+
+            // Blocks of a fixed size without early exit. The compiler can
+            // compare each block with a few wide instructions.
+            const uint8_t bins_per_block = 32;
+            uint16_t bin = 0;
+            while (bin + bins_per_block <= limit) {
+                data_t differences = 0;
+                for (uint8_t block_bin = 0; block_bin < bins_per_block; ++block_bin) {
+                    differences |= (data[tick + bin + block_bin]           ^ tick_value)     |
+                                   (data[ck_start_tick + bin + block_bin]  ^ ck_start_value) |
+                                   (data[ck_middle_tick + bin + block_bin] ^ ck_middle_value);
+                }
+                if (differences) {
+                    break;
+                }
+                bin += bins_per_block;
+            }
+            while (bin < limit && data[tick + bin]           == tick_value &&
+                                  data[ck_start_tick + bin]  == ck_start_value &&
+                                  data[ck_middle_tick + bin] == ck_middle_value) {
+                ++bin;
+            }
+            return bin;
+        }
+
+        // All bins at tick, ck_start_tick and ck_middle_tick have the value of their first
+        // bin. Thus the bins at tick get the same new value and the integral changes by
+        // the same difference for each bin. If the bins at tick change, count must not
+        // exceed bins_per_100ms, otherwise the convolution kernel would read them.
+        void phase_binning_constant(const uint8_t input, const index_t tick,
+                                    const index_t ck_start_tick, const index_t ck_middle_tick, const uint16_t count) {
+            data_t current = this->data[tick];
+            if (current > N) {
+                current = N;
+            }
+            if (input) {
+                current += current < N;
+            } else {
+                current -= current > 0;
+            }
+            if (current != this->data[tick]) {
+                for (uint16_t bin = 0; bin < count; ++bin) {
+                    this->data[tick + bin] = current;
+                }
+            }
+
+            const int32_t difference = (int32_t)this->data[ck_middle_tick] + (int32_t)current
+                                     - (int32_t)this->data[ck_start_tick]*2;
+
+            // the integral is monotonic, hence only the first or the last bin may be a new maximum
+            if (integral > running_max) {
+                running_max = integral;
+                running_max_index = ck_start_tick;
+            }
+            if (difference > 0) {
+                const int32_t last_integral = integral + (int32_t)(count - 1)*difference;
+                if (last_integral > running_max) {
+                    running_max = last_integral;
+                    running_max_index = ck_start_tick + count - 1;
+                }
+            }
+            integral += (int32_t)count*difference;
+
+            this->tick = tick + count - 1;
+        }
+
+        // Same as calling phase_binning(input) bins times. Instead of recomputing the
+        // wrapped indices for each bin the run is split into parts where none of the
+        // indices wraps. Most of the bins of a constant run are saturated at the
+        // input. Such parts are processed at once by phase_binning_constant.
+        void phase_binning_run(const uint8_t input, uint16_t bins) {
+            // shorter parts are processed bin by bin
+            const uint16_t min_constant_bins = 8;
+
+            while (bins > 0) {
+                const index_t tick = wrap(this->tick + 1);
+                const index_t noise_tick = wrap(this->signal_max_index + 2*bins_per_200ms);
+                if (tick == 0 || tick == noise_tick) {
+                    phase_binning(input);
+                    --bins;
+                    continue;
+                }
+
+                // ck = convolution_kernel
+                const index_t ck_start_tick  = wrap(tick+((10-2)*(uint16_t)bins_per_100ms));
+                const index_t ck_middle_tick = wrap(tick+((10-1)*(uint16_t)bins_per_100ms));
+
+                uint16_t limit = bins;
+                Arithmetic_Tools::minimize(limit, (uint16_t)(bin_count - tick));
+                Arithmetic_Tools::minimize(limit, (uint16_t)(bin_count - ck_start_tick));
+                Arithmetic_Tools::minimize(limit, (uint16_t)(bin_count - ck_middle_tick));
+                if (noise_tick > tick) {
+                    Arithmetic_Tools::minimize(limit, (uint16_t)(noise_tick - tick));
+                }
+
+                const bool saturated = input? this->data[tick] == N: this->data[tick] == 0;
+                uint16_t count = get_constant_bins(tick, ck_start_tick, ck_middle_tick,
+                                                   saturated? limit: min(limit, (uint16_t)bins_per_100ms));
+                if (count >= min_constant_bins) {
+                    phase_binning_constant(input, tick, ck_start_tick, ck_middle_tick, count);
+                } else {
+                    count = min(limit, (uint16_t)(4*min_constant_bins));
+                    phase_binning_bins(input, tick, ck_start_tick, ck_middle_tick, count);
+                }
+                bins -= count;
+            }
+        }
+
+        // Constant run fast path. Processes at most bins complete bins which all have
+        // the same input. It stops before any bin that would trigger a callback to
+        // the clock controller, i.e. flush() or process_single_tick_data(). Thus the
+        // clock controller can advance the local clock in one go afterwards.
+        // Must only be called if is_at_bin_start(). Returns the number of processed
+        // bins. The results are exactly the same as for calling detector() for each
+        // sample.
+        uint16_t detector_run(const uint8_t input, const uint16_t bins) {
+            uint16_t quiet_bins;
+            if (bins_to_go == 0) {
+                // detector_stage_2 will flush as soon as the current bin enters the window
+                // [signal_max_index-1, signal_max_index+bins_per_100ms-1]. Since the window
+                // may move whenever the tick wraps to 0 we stop before this as well.
+                const index_t window_start = wrap(bin_count + this->signal_max_index - 1);
+                const uint16_t bins_to_window = wrap(bin_count + window_start - this->tick - 1);
+                const uint16_t bins_to_wrap   = bin_count - 1 - this->tick;
+                const index_t next_bin = wrap(this->tick + 1);
+                if (wrap((bin_count + next_bin + 1 - this->signal_max_index)) <= bins_per_100ms ||
+                    wrap((bin_count + this->signal_max_index - next_bin)) <= 1) {
+                    quiet_bins = 0;
+                } else {
+                    quiet_bins = min(bins_to_window, bins_to_wrap);
+                }
+                Arithmetic_Tools::minimize(quiet_bins, bins);
+
+                phase_binning_run(input, quiet_bins);
+            } else {
+                // decode_200ms will pass the decoded data to the clock controller once
+                // bins_to_go reaches 0, up to then it will only count
+                quiet_bins = bins_to_go - 1;
+                Arithmetic_Tools::minimize(quiet_bins, bins);
+
+                if (bins_to_go > bins_per_100ms + 1 && bins_to_go - quiet_bins <= bins_per_100ms + 1) {
+                    // the first 100ms will be completed during this run
+                    const uint16_t first_bins = bins_to_go - (bins_per_100ms + 1);
+                    phase_binning_run(input, first_bins);
+                    count += input * first_bins;
+                    decoded_data = ((count > bins_per_50ms)? 2: 0);
+                    count = 0;
+
+                    phase_binning_run(input, quiet_bins - first_bins);
+                    count += input * (quiet_bins - first_bins);
+                } else {
+                    phase_binning_run(input, quiet_bins);
+                    count += input * quiet_bins;
+                }
+                bins_to_go -= quiet_bins;
             }
+            return quiet_bins;
         }
 
         void debug() {
             sprint(F("Phase: "));
-            Binning::Convoluter<uint16_t, Clock_Controller::Configuration::phase_lock_resolution>::debug();
+            Phase_Bins::debug();
+            fine_tracker.debug();
         }
 
         void debug_verbose() {
@@ -1246,7 +1968,11 @@ namespace Internal {
 
         static void cummulate(int8_t &average, const bool count_up);
 
+        static constexpr bool owns_second(const uint8_t second) {
+            return (second >= 15 && second <= 19) || second == 58;
+        }
         void process_tick(const uint8_t current_second, const uint8_t tick_value);
+        void set_DCF77_Encoder(DCF77_Encoder &now);
 
         void reset_after_previous_hour();
         void reset_before_new_day();
@@ -1302,7 +2028,12 @@ namespace Internal {
         DCF77_Decade_Decoder Decade_Decoder;
 
         void advance_tick();
+        static constexpr bool owns_second(const uint8_t second) {
+            return Binning::is_BCD_binning_second<DCF77_Year_template_parameters::BCD_binning_t>(second) ||
+                   Binning::is_BCD_binning_second<DCF77_Decade_template_parameters::BCD_binning_t>(second);
+        }
         void process_tick(const uint8_t current_second, const uint8_t tick_value);
+        void set_DCF77_Encoder(DCF77_Encoder &now);
         void get_quality(lock_quality_t &lock_quality);
         uint8_t get_quality_factor();
         BCD::bcd_t get_time_value();
@@ -1327,7 +2058,11 @@ namespace Internal {
     };
     struct DCF77_Month_Decoder : public Binning::Decoder<DCF77_Month_template_parameters::decoder_t::data_type,
                                                          DCF77_Month_template_parameters::decoder_t::number_of_bins> {
+        static constexpr bool owns_second(const uint8_t second) {
+            return Binning::is_BCD_binning_second<DCF77_Month_template_parameters::BCD_binning_t>(second);
+        }
         void process_tick(const uint8_t current_second, const uint8_t tick_value);
+        void set_DCF77_Encoder(DCF77_Encoder &now);
         void debug();
     };
 
@@ -1346,7 +2081,11 @@ namespace Internal {
     };
     struct DCF77_Weekday_Decoder : public Binning::Decoder<DCF77_Weekday_template_parameters::decoder_t::data_type,
                                                            DCF77_Weekday_template_parameters::decoder_t::number_of_bins> {
+        static constexpr bool owns_second(const uint8_t second) {
+            return Binning::is_BCD_binning_second<DCF77_Weekday_template_parameters::BCD_binning_t>(second);
+        }
         void process_tick(const uint8_t current_second, const uint8_t tick_value);
+        void set_DCF77_Encoder(DCF77_Encoder &now);
         void debug();
     };
 
@@ -1365,10 +2104,45 @@ namespace Internal {
     };
     struct DCF77_Day_Decoder : public Binning::Decoder<DCF77_Day_template_parameters::decoder_t::data_type,
                                                        DCF77_Day_template_parameters::decoder_t::number_of_bins> {
+        static constexpr bool owns_second(const uint8_t second) {
+            return Binning::is_BCD_binning_second<DCF77_Day_template_parameters::BCD_binning_t>(second);
+        }
         void process_tick(const uint8_t current_second, const uint8_t tick_value);
+        void set_DCF77_Encoder(DCF77_Encoder &now);
         void debug();
     };
 
+    // Stands in for the weekday, day, month and year decoders if
+    // Configuration::decode_date is false. It has no bins, owns no
+    // second and leaves its field of the date undefined.
+    template <BCD::bcd_t DCF77_Encoder::*field>
+    struct DCF77_Null_Decoder {
+        typedef Binning::lock_quality_tt<uint8_t> lock_quality_t;
+
+        static constexpr bool owns_second(const uint8_t /* second */) { return false; }
+        void process_tick(const uint8_t /* current_second */, const uint8_t /* tick_value */) {}
+        void advance_tick() {}
+
+        BCD::bcd_t get_time_value() {
+            BCD::bcd_t undefined;
+            undefined.val = 0xff;
+            return undefined;
+        }
+
+        void set_DCF77_Encoder(DCF77_Encoder &now) {
+            now.*field = get_time_value();
+        }
+
+        uint8_t get_quality_factor() { return 0; }
+        void get_quality(lock_quality_t &lock_quality) {
+            lock_quality.lock_max  = 0;
+            lock_quality.noise_max = 0;
+        }
+
+        void setup() {}
+        void debug() {}
+    };
+
     struct DCF77_Hour_template_parameters {
         struct decoder_t {
             typedef uint8_t data_type;
@@ -1384,7 +2158,11 @@ namespace Internal {
     };
     struct DCF77_Hour_Decoder : public Binning::Decoder<DCF77_Hour_template_parameters::decoder_t::data_type,
                                                         DCF77_Hour_template_parameters::decoder_t::number_of_bins> {
+        static constexpr bool owns_second(const uint8_t second) {
+            return Binning::is_BCD_binning_second<DCF77_Hour_template_parameters::BCD_binning_t>(second);
+        }
         void process_tick(const uint8_t current_second, const uint8_t tick_value);
+        void set_DCF77_Encoder(DCF77_Encoder &now);
         void debug();
     };
 
@@ -1423,7 +2201,12 @@ namespace Internal {
         //    --> to low and total startup time will increase
         static const uint8_t lock_threshold = 12;
 
-        DCF77::serialized_clock_stream convolution_kernel;
+        // The predicted minute frame, arranged such that bit b is the prediction
+        // for bin b at the current tick. The mask marks the predicted bits.
+        uint64_t prediction_bits;
+        uint64_t prediction_mask;
+        static uint64_t rotate_bins(const uint64_t bins);
+
         // used to determine how many of the predicted bits are actually observed,
         // also used to indicate if convolution is already applied
         static const uint8_t convolution_binning_not_ready = 0xff;
@@ -1444,9 +2227,53 @@ namespace Internal {
     struct DCF77_Local_Clock {
         Clock::clock_state_t clock_state;
         DCF77_Encoder local_clock_time;
-        volatile bool second_toggle;
+        volatile bool second_toggle = false;
         uint16_t tick;
 
+        // Sequence counter for lock free reads of local_clock_time. It is odd
+        // while local_clock_time is written. A reader that sees the same even
+        // value before and after copying the time got a consistent copy. As
+        // the time is written at most once per second the reads will hardly
+        // ever be retried.
+        volatile uint8_t time_sequence = 0;
+        static const uint8_t max_read_attempts = 4;
+
+        // Monotonic counter of the 1 kHz ticks since setup. The ticks are
+        // disciplined by the frequency control. Thus the counter is as
+        // accurate as the local clock but it never jumps, not even on resync.
+        // 64 bits will not overflow within the next 500 million years.
+        uint64_t milliseconds = 0;
+        // Sequence counter for lock free reads of milliseconds, odd while it is
+        // written. With Configuration::deferred_processing milliseconds is written
+        // by poll(). An interrupt that preempts this write can not get a consistent
+        // copy, hence the try_read functions fail instead of returning a torn value.
+        volatile uint8_t milliseconds_sequence = 0;
+        // Value of milliseconds at the start of the current second. It is
+        // part of the time, that is it is written under the sequence counter.
+        uint64_t second_start_milliseconds = 0;
+
+        // only used by try_get_current_time
+        bool reported_second_toggle = false;
+
+        void begin_time_update() {
+            ++time_sequence;
+            MEMORY_BARRIER;
+        }
+
+        void end_time_update() {
+            second_start_milliseconds = milliseconds - tick;
+            MEMORY_BARRIER;
+            ++time_sequence;
+        }
+
+        void advance_milliseconds(const uint16_t ticks) {
+            ++milliseconds_sequence;
+            MEMORY_BARRIER;
+            milliseconds += ticks;
+            MEMORY_BARRIER;
+            ++milliseconds_sequence;
+        }
+
         // This will take more than 100 years to overflow.
         // An overflow would indicate that the clock is
         // running for >100 years without a sync.
@@ -1456,23 +2283,26 @@ namespace Internal {
         void setup() {
             clock_state = Clock::useless;
             tick = 0;
+            milliseconds = 0;
             unlocked_seconds = 0;
             // untuned resonators suck
             max_unlocked_seconds = 3000;
 
+            begin_time_update();
             local_clock_time.reset();
+            end_time_update();
         }
 
-        void process_1_Hz_tick(const DCF77_Encoder &decoded_time) {
-            uint8_t quality_factor = Clock_Controller::get_overall_quality_factor();
+        void process_1_Hz_tick(Clock_Controller &clock_controller, const DCF77_Encoder &decoded_time) {
+            uint8_t quality_factor = clock_controller.get_overall_quality_factor();
 
             if (quality_factor > Clock_Controller::Configuration::quality_factor_sync_threshold) {
                 if (clock_state != Clock::synced) {
-                    Clock_Controller::sync_achieved_event_handler();
+                    clock_controller.sync_achieved_event_handler();
                     clock_state = Clock::synced;
                 }
             } else if (clock_state == Clock::synced) {
-                Clock_Controller::sync_lost_event_handler();
+                clock_controller.sync_lost_event_handler();
                 clock_state = Clock::locked;
             }
 
@@ -1492,12 +2322,16 @@ namespace Internal {
                         if (quality_factor == 0) {
                             clock_state = Clock::useless;
                             second_toggle = !second_toggle;
+                            begin_time_update();
                             local_clock_time.reset();
+                            end_time_update();
                             return;
                         } else {
                             tick = 0;
+                            begin_time_update();
                             local_clock_time = decoded_time;
-                            Clock_Controller::local_clock_flush(decoded_time);
+                            end_time_update();
+                            clock_controller.local_clock_flush(decoded_time);
                             second_toggle = !second_toggle;
                             return;
                         }
@@ -1505,38 +2339,42 @@ namespace Internal {
 
                     case Clock::synced: {
                         tick = 0;
+                        begin_time_update();
                         local_clock_time = decoded_time;
-                        Clock_Controller::local_clock_flush(decoded_time);
+                        end_time_update();
+                        clock_controller.local_clock_flush(decoded_time);
                         second_toggle = !second_toggle;
                         return;
                     }
 
                     case Clock::locked: {
-                        if (Clock_Controller::get_demodulator_quality_factor() > Configuration::unacceptable_demodulator_quality) {
+                        if (clock_controller.get_demodulator_quality_factor() > Configuration::unacceptable_demodulator_quality) {
                             // If we are not sure about leap seconds we will skip
                             // them. Worst case is that we miss a leap second due
                             // to noisy reception. This may happen at most once a
                             // year.
+                            tick = 0;
+                            begin_time_update();
                             local_clock_time.leap_second_scheduled = false;
 
                             // autoset_control_bits is not required because
                             // advance_second will call this internally anyway
                             //local_clock_time.autoset_control_bits();
                             local_clock_time.advance_second();
-                            Clock_Controller::local_clock_flush(local_clock_time);
-                            tick = 0;
+                            end_time_update();
+                            clock_controller.local_clock_flush(local_clock_time);
                             second_toggle = !second_toggle;
                             return;
                         } else {
                             clock_state = Clock::unlocked;
-                            Clock_Controller::phase_lost_event_handler();
+                            clock_controller.phase_lost_event_handler();
                             unlocked_seconds = 0;
                             return;
                         }
                     }
 
                     case Clock::unlocked: {
-                        if (Clock_Controller::get_demodulator_quality_factor() > Configuration::unacceptable_demodulator_quality) {
+                        if (clock_controller.get_demodulator_quality_factor() > Configuration::unacceptable_demodulator_quality) {
                             // Quality is somewhat reasonable again, check
                             // if the phase offset is in reasonable bounds.
                             if (200 < tick && tick < 800) {
@@ -1556,6 +2394,9 @@ namespace Internal {
                                 if (tick < 200) {
                                     // time output was handled at most 200 ms before
                                     tick = 0;
+                                    // the second starts again, now in phase
+                                    begin_time_update();
+                                    end_time_update();
                                     return;
                                 } else {
                                     break;  // goto locked state
@@ -1574,8 +2415,9 @@ namespace Internal {
             }
         }
 
-        void process_1_kHz_tick() {
+        void process_1_kHz_tick(Clock_Controller &clock_controller) {
             ++tick;
+            advance_milliseconds(1);
 
             if (clock_state == Clock::synced || clock_state == Clock::locked) {
                 // the important part is 150 < 200,
@@ -1587,7 +2429,7 @@ namespace Internal {
 
                     // 1 Hz tick missing for more than 1200ms
                     clock_state = Clock::unlocked;
-                    Clock_Controller::phase_lost_event_handler();
+                    clock_controller.phase_lost_event_handler();
                 }
             }
 
@@ -1599,13 +2441,15 @@ namespace Internal {
                     // them. Worst case is that we miss a leap second due
                     // to noisy reception. This may happen at most once a
                     // year.
+                    begin_time_update();
                     local_clock_time.leap_second_scheduled = false;
 
                     // autoset_control_bits is not required because
                     // advance_second will call this internally anyway
                     //local_clock_time.autoset_control_bits();
                     local_clock_time.advance_second();
-                    Clock_Controller::local_clock_flush(local_clock_time);
+                    end_time_update();
+                    clock_controller.local_clock_flush(local_clock_time);
                     second_toggle = !second_toggle;
 
                     ++unlocked_seconds;
@@ -1616,6 +2460,22 @@ namespace Internal {
             }
         }
 
+        // Number of 1 kHz ticks that will pass without any state change
+        // besides incrementing tick.
+        uint16_t get_quiet_ticks() const {
+            const uint16_t event_tick = (clock_state == Clock::synced   || clock_state == Clock::locked)? 1150:
+                                        (clock_state == Clock::unlocked || clock_state == Clock::free  )? 1000:
+                                                                                                          0xFFFF;
+            return tick + 1 < event_tick? event_tick - 1 - tick: 0;
+        }
+
+        // Same as calling process_1_kHz_tick() ticks times, ticks must not
+        // exceed get_quiet_ticks().
+        void process_1_kHz_ticks(const uint16_t ticks) {
+            tick += ticks;
+            advance_milliseconds(ticks);
+        }
+
         uint32_t max_unlocked_seconds;
         void set_has_tuned_clock() {
             // even tuned resonators suck,
@@ -1627,10 +2487,89 @@ namespace Internal {
             return clock_state;
         }
 
+        // non-blocking, lock free, reads current second
+        // fails only if the time was written during each of the attempts
+        bool try_read_current_time(DCF77_Encoder &now) {
+            for (uint8_t attempt = 0; attempt < max_read_attempts; ++attempt) {
+                const uint8_t sequence = time_sequence;
+                if (sequence & 1) { continue; }
+                MEMORY_BARRIER;
+                now = local_clock_time;
+                MEMORY_BARRIER;
+                if (sequence == time_sequence) { return true; }
+            }
+            return false;
+        }
+
         // non-blocking, reads current second
+        // With Configuration::deferred_processing it must not be called from an
+        // interrupt. If the interrupt preempts poll() while it writes the time
+        // even the fallback can not get a consistent copy, use try_read_current_time.
         void read_current_time(DCF77_Encoder &now) {
-            CRITICAL_SECTION {
+            if (!try_read_current_time(now)) {
+                // only if the reads were interrupted again and again
+                CRITICAL_SECTION {
+                    now = local_clock_time;
+                }
+            }
+        }
+
+        // non-blocking, lock free
+        // fails only if milliseconds was written during each of the attempts
+        bool try_read_milliseconds(uint64_t &value) {
+            for (uint8_t attempt = 0; attempt < max_read_attempts; ++attempt) {
+                const uint8_t sequence = milliseconds_sequence;
+                if (sequence & 1) { continue; }
+                MEMORY_BARRIER;
+                value = milliseconds;
+                MEMORY_BARRIER;
+                if (sequence == milliseconds_sequence) { return true; }
+            }
+            return false;
+        }
+
+        // non-blocking, lock free
+        // With Configuration::deferred_processing it must not be called from an
+        // interrupt, it would spin forever if the interrupt preempts poll() while
+        // it writes milliseconds. Use try_read_milliseconds instead.
+        uint64_t read_milliseconds() {
+            uint64_t value;
+            while (!try_read_milliseconds(value)) {
+                // only if milliseconds was written again and again
+            }
+            return value;
+        }
+
+        // non-blocking, lock free, reads current second and the milliseconds since
+        // its start, the milliseconds will not exceed 999
+        bool try_read_current_time(DCF77_Encoder &now, uint16_t &millisecond) {
+            for (uint8_t attempt = 0; attempt < max_read_attempts; ++attempt) {
+                const uint8_t sequence = time_sequence;
+                if (sequence & 1) { continue; }
+                MEMORY_BARRIER;
                 now = local_clock_time;
+                const uint64_t second_start = second_start_milliseconds;
+                uint64_t current;
+                if (!try_read_milliseconds(current)) { continue; }
+                MEMORY_BARRIER;
+                if (sequence == time_sequence) {
+                    // in locked state the next second may be up to 150 ms late
+                    millisecond = min(current - second_start, (uint64_t)999);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // non-blocking, reads current second and the milliseconds since its start
+        // With Configuration::deferred_processing not from an interrupt, see above.
+        void read_current_time(DCF77_Encoder &now, uint16_t &millisecond) {
+            if (!try_read_current_time(now, millisecond)) {
+                // only if the reads were interrupted again and again
+                CRITICAL_SECTION {
+                    now = local_clock_time;
+                    millisecond = min(milliseconds - second_start_milliseconds, (uint64_t)999);
+                }
             }
         }
 
@@ -1643,6 +2582,22 @@ namespace Internal {
             read_current_time(now);
         }
 
+        // non-blocking version of get_current_time
+        // succeeds only once per second, that is if the second started
+        // after the previous successful call
+        bool try_get_current_time(DCF77_Encoder &now) {
+            const bool toggle = second_toggle;
+            if (toggle == reported_second_toggle) { return false; }
+
+            MEMORY_BARRIER;
+            if (!try_read_current_time(now) || toggle != second_toggle) {
+                // the next second started while we were reading, try again later
+                return false;
+            }
+            reported_second_toggle = toggle;
+            return true;
+        }
+
         void debug() {
             sprint(F("Clock state: "));
             switch (clock_state) {
@@ -1659,22 +2614,32 @@ namespace Internal {
         }
     };
 
-    struct DCF77_Frequency_Control {
+    // The frequency control is parametrized with the resolution of the phase
+    // that drives the local clock (Configuration::phase_tracking_resolution).
+    // Thus clock controllers with different configurations, e.g. those of the
+    // debug helper, each measure the drift with their own resolution.
+    template <uint16_t phase_tracking_resolution>
+    struct DCF77_Frequency_Control_T {
         // Precision at tau min is 8 Hz == 0.5 ppm or better
         // This is because 340 m = 334 * 60 * 100 centiseconds = 2 004 000 centiseconds
         //                  34 m = 34 * 60 * 1000 milliseconds = 2 040 000 ms
 
         // Do not decrease this value!
-        static const uint16_t tau_min_minutes = 2000000uL / (60uL * Configuration::phase_lock_resolution) + 1;
+        static const uint16_t tau_min_minutes = 2000000uL / (60uL * phase_tracking_resolution) + 1;
 
         // Precision at tau_max would be 0.5 Hz
         // This may be decreased if desired. Do not decrease below 2*tau_min.
         // 5334 * 6000 = 32 004 000 // 534 * 60000 = 32 040 000
-        static const uint16_t tau_max_minutes = 32000000uL / (60uL * Configuration::phase_lock_resolution) + 1;
+        static const uint16_t tau_max_minutes = 32000000uL / (60uL * phase_tracking_resolution) + 1;
 
         static const int16_t max_total_adjust = Configuration::maximum_total_frequency_adjustment;
 
-        static volatile int8_t confirmed_precision;
+        volatile int8_t confirmed_precision = 0;
+
+        // The frequency adjustment that is applied by the 1 kHz generator.
+        // It is kept with the frequency control such that each clock
+        // controller instance is tuned independently.
+        int16_t adjust_pp16m = 0;
 
         // 2*tau_max = 32 004 000 ticks = 5333 minutes or 533 minutes depending on the resolution
         //  60 000 centi seconds = 10 minutes
@@ -1682,14 +2647,14 @@ namespace Internal {
         // maximum drift in 32 004 000 ticks @ 900 ppm would result
         // in a drift of +/- 28800 ticks
         // thus it is uniquely measured if we know it mod 60 000
-        // However in the centi seconds case we will require slighty more
+        // However for the lower resolutions we will require slighty more
         // complicated logic due to the additional divider.
         //template <Configuration::ticks_per_second_t phase_lock_resolution>
         struct generic_deviation_tracker_t {
-            volatile uint16_t elapsed_minutes;
-            volatile uint16_t elapsed_ticks_mod_60000;
+            volatile uint16_t elapsed_minutes = 0;
+            volatile uint16_t elapsed_ticks_mod_60000 = 0;
 
-            void start(const uint8_t minute_mod_10) {
+            void start(const uint8_t minute) {
                 elapsed_ticks_mod_60000 = 0;
                 elapsed_minutes = 0;
             }
@@ -1703,7 +2668,16 @@ namespace Internal {
                 }
             }
 
-            int16_t compute_phase_deviation(uint8_t current_second, uint8_t current_minute_mod_10) {
+            void process_ticks(const uint16_t ticks) {
+                uint32_t elapsed_ticks = (uint32_t)elapsed_ticks_mod_60000 + ticks;
+                while (elapsed_ticks >= 60000) {
+                    elapsed_ticks -= 60000;
+                    ++elapsed_minutes;
+                }
+                elapsed_ticks_mod_60000 = elapsed_ticks;
+            }
+
+            int16_t compute_phase_deviation(uint8_t current_second, uint8_t current_minute) {
                 int32_t deviation =
                         ((int32_t) elapsed_ticks_mod_60000) -
                         ((int32_t) current_second - (int32_t) calibration_second) * 1000;
@@ -1725,17 +2699,25 @@ namespace Internal {
             }
         };
 
+        // Counts ticks of the phase tracking resolution, i.e. one tick per
+        // samples_per_tick 1 kHz ticks. 60 000 ticks are minutes_per_wrap
+        // minutes, e.g. 10 minutes for centi seconds. This divides 60, hence
+        // the minute of the decoded time resolves the ambiguity.
         struct averaging_deviation_tracker_t : generic_deviation_tracker_t {
-            uint8_t start_minute_mod_10;
+            static const uint8_t  samples_per_tick = 1000 / phase_tracking_resolution;
+            static const uint16_t ticks_per_minute = 60 * phase_tracking_resolution;
+            static const uint8_t  minutes_per_wrap = 60000uL / ticks_per_minute;
+
+            uint8_t start_minute = 0;
             uint8_t divider = 0;
 
-            void start(const uint8_t minute_mod_10) {
-                generic_deviation_tracker_t::start(minute_mod_10);
-                start_minute_mod_10 = minute_mod_10;
+            void start(const uint8_t minute) {
+                generic_deviation_tracker_t::start(minute);
+                start_minute = minute;
             }
 
             void process_tick() {
-                if (divider < 9) {
+                if (divider < samples_per_tick - 1) {
                     ++divider;
                 }  else {
                     divider = 0;
@@ -1743,17 +2725,28 @@ namespace Internal {
                     // in this
                     generic_deviation_tracker_t::process_tick();
 
-                    if (elapsed_ticks_mod_60000 % 6000 == 0) {
-                        ++elapsed_minutes;
+                    // the wrap to 0 was already counted by the generic tracker
+                    if (this->elapsed_ticks_mod_60000 % ticks_per_minute == 0 && this->elapsed_ticks_mod_60000 != 0) {
+                        ++this->elapsed_minutes;
                     }
                 }
             }
 
-            int16_t compute_phase_deviation(uint8_t current_second, uint8_t current_minute_mod_10) {
+            // Each multiple of ticks_per_minute that is passed counts as a minute. As
+            // 60000 is such a multiple this includes the wrap to 0.
+            void process_ticks(const uint16_t ticks) {
+                const uint32_t elapsed_ticks = (uint32_t)this->elapsed_ticks_mod_60000 + (divider + ticks) / samples_per_tick;
+                divider = (divider + ticks) % samples_per_tick;
+
+                this->elapsed_minutes += elapsed_ticks / ticks_per_minute - this->elapsed_ticks_mod_60000 / ticks_per_minute;
+                this->elapsed_ticks_mod_60000 = elapsed_ticks % 60000;
+            }
+
+            int16_t compute_phase_deviation(uint8_t current_second, uint8_t current_minute) {
                 int32_t deviation =
-                        ((int32_t) elapsed_ticks_mod_60000) -
-                        ((int32_t) current_second        - (int32_t) calibration_second)  * 100 -
-                        ((int32_t) current_minute_mod_10 - (int32_t) start_minute_mod_10) * 6000;
+                        ((int32_t) this->elapsed_ticks_mod_60000) -
+                        ((int32_t) current_second - (int32_t) calibration_second) * phase_tracking_resolution -
+                        ((int32_t) ((60 + current_minute - start_minute) % minutes_per_wrap)) * ticks_per_minute;
 
                 // ensure we are between 30000 and -29999
                 while (deviation >  30000) { deviation -= 60000; }
@@ -1763,10 +2756,10 @@ namespace Internal {
             }
         };
 
-        typedef TMP::if_t<Configuration::high_phase_lock_resolution,
-                         generic_deviation_tracker_t,
-                         averaging_deviation_tracker_t>::type deviation_tracker_t;
-        static deviation_tracker_t deviation_tracker;
+        typedef typename TMP::if_t<phase_tracking_resolution == Configuration::milli_seconds,
+                                   generic_deviation_tracker_t,
+                                   averaging_deviation_tracker_t>::type deviation_tracker_t;
+        deviation_tracker_t deviation_tracker;
 
         // Seconds 0 and 15 already receive more computation than
         // other seconds thus calibration will run in second 5.
@@ -1778,43 +2771,187 @@ namespace Internal {
             bool running   : 1;
         } calibration_state_t;
 
-        static volatile calibration_state_t calibration_state;
-        static volatile int16_t deviation;
+        volatile calibration_state_t calibration_state = {false, false};
+        volatile int16_t deviation = 0;
 
-        static void restart_measurement();
-        static void debug();
-        static bool increase_tau();
-        static bool decrease_tau();
-        static void adjust();
-        static void process_1_Hz_tick(const DCF77_Encoder &decoded_time);
-        static void process_1_kHz_tick();
+        void restart_measurement();
+        bool increase_tau();
+        bool decrease_tau();
 
-        static void qualify_calibration();
-        static void unqualify_calibration();
-// TODO msres: how to deal with lower vs. higher resolution, different arguments needed
-        static int16_t compute_phase_deviation(uint8_t current_second, uint8_t current_minute_mod_10);
+        void debug() {
+            using namespace Debug;
+            sprintln(F("confirmed_precision ?? adjustment, deviation, elapsed"));
+            sprintpp16m(confirmed_precision);
+            sprint(F(", "));
+            sprint(calibration_state.running? '@': '.');
+            sprint(calibration_state.qualified? '+': '-');
+            sprint(' ');
 
-        static calibration_state_t get_calibration_state();
-        // The phase deviation is only meaningful if calibration is running.
-        static int16_t get_current_deviation();
+            sprint(F(", "));
+            sprintpp16m(read_adjustment());
+            sprint(F(", "));
 
-        static void setup();
+            sprint(deviation);
+            sprint(F(" ticks, "));
 
+            sprint(deviation_tracker.elapsed_minutes);
+            sprint(F(" min + "));
+            sprint(deviation_tracker.elapsed_ticks_mod_60000);
+            sprintln(F(" ticks mod 60000"));
+        }
 
-        // get the adjust step that was used for the last adjustment
-        //   if there was no adjustment or if the frequency adjustment was poor it will return 0
-        static int8_t get_confirmed_precision();
-    };
+        void adjust() {
+            int16_t total_adjust = read_adjustment();
+            // The proper formula would be
+            //     int32_t adjust == (16 000 000 / (elapsed_minutes * 60 * phase_tracking_resolution)) * new_deviation;
+            // The total error of the formula below is ~ 1/(3*elapsed_minutes)
+            //     which is  ~ 1/1000 (for centisecond resolution) and ~1/100 for millisecond resolution,
+            //     the intermediate resolutions are in between
+            // Also notice that 2667*deviation will not overflow even if the
+            // local clock would deviate by more than 400 ppm or 6 kHz
+            // from its nominal frequency.
+            // Finally notice that the frequency_offset will always be rounded towards zero
+            // while the confirmed_precision is rounded away from zero. The first should
+            // be considered a kind of relaxation while the second should be considered
+            // a defensive computation.
+            const int16_t minutes_per_16000000_ticks = 16000000uL / 60 / phase_tracking_resolution;
+            const int16_t frequency_offset = ((minutes_per_16000000_ticks * (int32_t)deviation) /
+                                               deviation_tracker.elapsed_minutes);
+            // In doubt confirmed precision will be slightly larger than the true value
+            confirmed_precision = ((minutes_per_16000000_ticks - 1) + deviation_tracker.elapsed_minutes) /
+                                    deviation_tracker.elapsed_minutes;
+            if (confirmed_precision == 0) { confirmed_precision = 1; }
+
+            total_adjust -= frequency_offset;
+
+            if (total_adjust >  max_total_adjust) { total_adjust =  max_total_adjust; }
+            if (total_adjust < -max_total_adjust) { total_adjust = -max_total_adjust; }
+
+            set_adjustment(total_adjust);
+        }
 
-    // Dummy class to parametrize a clock controller without frequency control
-    struct DCF77_No_Frequency_Control {
-        static void process_1_Hz_tick(const DCF77_Encoder &decoded_time);
-        static void process_1_kHz_tick();
+        // returns true if the clock was tuned during this tick
+        bool process_1_Hz_tick(const DCF77_Encoder &decoded_time) {
+            const int16_t deviation_to_trigger_readjust = 5;
+            bool tuned = false;
+
+            deviation = compute_phase_deviation(decoded_time.second, BCD::bcd_to_int(decoded_time.minute));
+
+            if (decoded_time.second == calibration_second) {
+                // We might be in an unqualified state and thus the leap second information
+                // we have might be wrong.
+                // However if we fail to detect an actual leap second, calibration will be wrong
+                // by 1 second.
+                // Therefore we assume a leap second and verify_leap_second_scheduled()
+                // will tell us if our assumption could actually be a leap second.
+                if (decoded_time.verify_leap_second_scheduled(true)) {
+                    // Leap seconds will mess up our frequency computations.
+                    // Handling them properly would be slightly more complicated.
+                    // Since leap seconds may only happen every 3 months we just
+                    // stop calibration for leap seconds and do nothing else.
+                    calibration_state.running = false;
+                }
 
-        static void qualify_calibration();
-        static void unqualify_calibration();
+                if (calibration_state.running) {
+                    if (calibration_state.qualified) {
+                        if ((Configuration::has_stable_ambient_temperature && deviation_tracker.good_enough() && abs(deviation) >= deviation_to_trigger_readjust) ||
+                             deviation_tracker.timeout()) {
+                            adjust();
+                            tuned = true;
 
-        static void setup();
+                            // restart calibration next second
+                            calibration_state.running = false;
+                        }
+                    } else {
+                        // unqualified
+                        if (deviation_tracker.timeout()) {
+                            // running unqualified for more than tau minutes
+                            //   --> the current calibration attempt is doomed
+                            calibration_state.running = false;
+                        }
+                        // else running but unqualified --> wait for better state
+                    }
+                } else {
+                    // (calibration_state.running == false) --> waiting
+                    if (calibration_state.qualified) {
+                        deviation_tracker.start(BCD::bcd_to_int(decoded_time.minute));
+                        calibration_state.running = true;
+                    }
+                    // else waiting but unqualified --> nothing to do
+                }
+            }
+            return tuned;
+        }
+
+        void process_1_kHz_tick() {
+            deviation_tracker.process_tick();
+        }
+
+        // same as calling process_1_kHz_tick() ticks times
+        void process_1_kHz_ticks(const uint16_t ticks) {
+            deviation_tracker.process_ticks(ticks);
+        }
+
+        void qualify_calibration() {
+            calibration_state.qualified = true;
+        }
+
+        void unqualify_calibration() {
+            calibration_state.qualified = false;
+        }
+
+        int16_t compute_phase_deviation(uint8_t current_second, uint8_t current_minute) {
+            return deviation_tracker.compute_phase_deviation(current_second, current_minute);
+        }
+
+        calibration_state_t get_calibration_state() {
+            return *(calibration_state_t *)&calibration_state;
+        }
+
+        // The phase deviation is only meaningful if calibration is running.
+        int16_t get_current_deviation() {
+            return deviation;
+        }
+
+        // positive_value --> increase frequency
+        // pp16m = parts per 16 million = 1 Hz @ 16 Mhz
+        void set_adjustment(const int16_t pp16m) {
+            CRITICAL_SECTION {
+                adjust_pp16m = pp16m;
+            }
+        }
+
+        int16_t read_adjustment() {
+            int16_t pp16m;
+            CRITICAL_SECTION {
+                pp16m = adjust_pp16m;
+            }
+            return pp16m;
+        }
+
+        void setup() {}
+
+
+        // get the adjust step that was used for the last adjustment
+        //   if there was no adjustment or if the frequency adjustment was poor it will return 0
+        int8_t get_confirmed_precision() {
+            return confirmed_precision;
+        }
+    };
+
+    // The frequency control of the library's own clock controller
+    typedef DCF77_Frequency_Control_T<Configuration::phase_tracking_resolution> DCF77_Frequency_Control;
+
+    // Dummy class to parametrize a clock controller without frequency control
+    struct DCF77_No_Frequency_Control {
+        static bool process_1_Hz_tick(const DCF77_Encoder &decoded_time);
+        static void process_1_kHz_tick();
+        static void process_1_kHz_ticks(const uint16_t ticks);
+
+        static void qualify_calibration();
+        static void unqualify_calibration();
+
+        static void setup();
 
         #if defined(__AVR__)
         static void auto_persist();  // this is slow and messes with the interrupt flag, do not call during interrupt handling
@@ -1825,49 +2962,307 @@ namespace Internal {
         void debug_helper(char data);
         void bcddigit(uint8_t data);
         void bcddigits(uint8_t data);
-        void sprintpp16m(int16_t pp16m);
     }
 
     namespace DCF77_Naive_Bitstream_Decoder {
         void set_bit(const uint8_t second, const uint8_t value, DCF77_Encoder &now);
     }
 
-    template <typename Configuration_T, typename Frequency_Control>
+    // Decoder pipeline
+    //
+    // The decoders that follow the minute decoder each own some seconds of the
+    // minute. The pipeline is a list of stages, one per decoder. It generates a
+    // table with one entry per second. Each entry has one bit per stage that
+    // owns the second, thus each second invokes only the decoders of its bits.
+    // The pipeline also runs the advances, the resets and fills the DCF77_Encoder.
+    enum decoder_advance_t : uint8_t {
+        never_advance = 0,  // the decoded value does not follow the clock
+        follow_hour   = 1,  // at the start of each hour advances until it matches the hour
+        count_weekday = 2,  // advances at the start of each day
+        follow_day    = 3,  // at the start of each day advances until it matches the day
+        count_month   = 4,  // advances at the start of each month
+        count_year    = 5   // advances at the start of each year
+    };
+
+    // called at the start of each hour, now is the time of the new hour
+    template <decoder_advance_t advance_policy> struct Decoder_Advance {};
+
+    template <> struct Decoder_Advance<never_advance> {
+        template <typename Decoder> static void advance(Decoder &, const DCF77_Encoder &) {}
+    };
+
+    template <> struct Decoder_Advance<follow_hour> {
+        template <typename Decoder> static void advance(Decoder &decoder, const DCF77_Encoder &now) {
+            // "while" takes automatically care of timezone change
+            while (decoder.get_time_value().val <= 0x23 &&
+                   decoder.get_time_value().val != now.hour.val) {
+                decoder.advance_tick();
+            }
+        }
+    };
+
+    template <> struct Decoder_Advance<count_weekday> {
+        template <typename Decoder> static void advance(Decoder &decoder, const DCF77_Encoder &now) {
+            if (now.hour.val == 0x00 && decoder.get_time_value().val <= 0x07) {
+                decoder.advance_tick();
+            }
+        }
+    };
+
+    template <> struct Decoder_Advance<follow_day> {
+        template <typename Decoder> static void advance(Decoder &decoder, const DCF77_Encoder &now) {
+            if (now.hour.val != 0x00) { return; }
+            // "while" takes automatically care of different month lengths
+            while (decoder.get_time_value().val <= 0x31 &&
+                   decoder.get_time_value().val != now.day.val) {
+                decoder.advance_tick();
+            }
+        }
+    };
+
+    template <> struct Decoder_Advance<count_month> {
+        template <typename Decoder> static void advance(Decoder &decoder, const DCF77_Encoder &now) {
+            if (now.hour.val == 0x00 && now.day.val == 0x01 && decoder.get_time_value().val <= 0x12) {
+                decoder.advance_tick();
+            }
+        }
+    };
+
+    template <> struct Decoder_Advance<count_year> {
+        template <typename Decoder> static void advance(Decoder &decoder, const DCF77_Encoder &now) {
+            if (now.hour.val == 0x00 && now.day.val == 0x01 && now.month.val == 0x01 && now.year.val <= 0x99) {
+                decoder.advance_tick();
+            }
+        }
+    };
+
+    enum decoder_reset_t : uint8_t {
+        never_reset    = 0,  // keeps its state until the clock controller is set up
+        reset_only     = 1,  // is reset along with its predecessors
+        reset_and_gate = 2   // is reset along with its predecessors, if its quality
+                             // factor is 0 the successors are reset on sync loss
+    };
+
+    template <decoder_reset_t reset_policy> struct Decoder_Reset {};
+
+    template <> struct Decoder_Reset<never_reset> {
+        template <typename Decoder> static void setup(Decoder &) {}
+        template <typename Decoder> static bool sync_lost(Decoder &, const bool reset_successors) {
+            return reset_successors;
+        }
+    };
+
+    template <> struct Decoder_Reset<reset_only> {
+        template <typename Decoder> static void setup(Decoder &decoder) { decoder.setup(); }
+        template <typename Decoder> static bool sync_lost(Decoder &decoder, const bool reset_successors) {
+            if (reset_successors) { decoder.setup(); }
+            return reset_successors;
+        }
+    };
+
+    template <> struct Decoder_Reset<reset_and_gate> {
+        template <typename Decoder> static void setup(Decoder &decoder) { decoder.setup(); }
+        template <typename Decoder> static bool sync_lost(Decoder &decoder, const bool reset_successors) {
+            if (reset_successors) { decoder.setup(); }
+            return reset_successors || decoder.get_quality_factor() == 0;
+        }
+    };
+
+    template <typename Clock_Controller, typename Decoder, Decoder Clock_Controller::*decoder,
+              decoder_advance_t advance_policy, decoder_reset_t reset_policy>
+    struct Decoder_Stage {
+        typedef Decoder decoder_t;
+        static const bool advances = advance_policy != never_advance;
+
+        static Decoder &get(Clock_Controller &clock_controller) {
+            return clock_controller.*decoder;
+        }
+
+        static void advance(Clock_Controller &clock_controller, const DCF77_Encoder &now) {
+            Decoder_Advance<advance_policy>::advance(get(clock_controller), now);
+        }
+
+        static void setup(Clock_Controller &clock_controller) {
+            Decoder_Reset<reset_policy>::setup(get(clock_controller));
+        }
+
+        static bool sync_lost(Clock_Controller &clock_controller, const bool reset_successors) {
+            return Decoder_Reset<reset_policy>::sync_lost(get(clock_controller), reset_successors);
+        }
+    };
+
+    template <typename... stages>
+    struct Decoder_Pipeline {
+        // the empty pipeline ends the recursion
+        static constexpr uint8_t get_stage_bits(const uint8_t /* second */, const uint8_t /* stage_bit */) { return 0; }
+        static constexpr uint8_t get_advancing_stages(const uint8_t /* stage_bit */) { return 0; }
+
+        template <typename Clock_Controller>
+        static void process_tick(Clock_Controller &, const uint8_t, const uint8_t, const uint8_t) {}
+
+        template <typename Clock_Controller>
+        static void advance(Clock_Controller &, const DCF77_Encoder &) {}
+
+        template <typename Clock_Controller>
+        static void process_stage(Clock_Controller &, const uint8_t, const bool, const DCF77_Encoder &, const uint8_t) {}
+
+        template <typename Clock_Controller>
+        static void set_DCF77_Encoder(Clock_Controller &, DCF77_Encoder &) {}
+
+        template <typename Clock_Controller>
+        static void setup(Clock_Controller &) {}
+
+        template <typename Clock_Controller>
+        static void sync_lost(Clock_Controller &, const bool) {}
+    };
+
+    template <typename stage, typename... stages>
+    struct Decoder_Pipeline<stage, stages...> {
+        typedef Decoder_Pipeline<stages...> successors;
+        static const uint8_t seconds_per_minute = 60;
+
+        // has stage_bit set if stage owns the second, the successors use the higher bits
+        static constexpr uint8_t get_stage_bits(const uint8_t second, const uint8_t stage_bit) {
+            return (stage::decoder_t::owns_second(second)? stage_bit: 0) |
+                   successors::get_stage_bits(second, stage_bit << 1);
+        }
+
+        struct dispatch_generator_t {
+            static constexpr uint8_t value(const uint8_t second) {
+                return get_stage_bits(second, 1);
+            }
+        };
+
+        // the bits of the stages that own the second
+        static uint8_t get_stages(const uint8_t second) {
+            typedef TMP::table_t<dispatch_generator_t, seconds_per_minute> dispatch_table;
+            return DCF77_READ_PROGMEM_BYTE(&dispatch_table::data[second]);
+        }
+
+        // has stage_bit set if the stage follows the clock at the start of each hour
+        static constexpr uint8_t get_advancing_stages(const uint8_t stage_bit = 1) {
+            return (stage::advances? stage_bit: 0) | successors::get_advancing_stages(stage_bit << 1);
+        }
+
+        template <typename Clock_Controller>
+        static void process_tick(Clock_Controller &clock_controller, const uint8_t stage_bits,
+                                 const uint8_t current_second, const uint8_t tick_value) {
+            if (stage_bits & 1) {
+                stage::get(clock_controller).process_tick(current_second, tick_value);
+            }
+            if (stage_bits > 1) {
+                successors::process_tick(clock_controller, stage_bits >> 1, current_second, tick_value);
+            }
+        }
+
+        // to be called at the start of each hour
+        template <typename Clock_Controller>
+        static void advance(Clock_Controller &clock_controller, const DCF77_Encoder &now) {
+            stage::advance(clock_controller, now);
+            successors::advance(clock_controller, now);
+        }
+
+        // advances the single stage with stage_bit if now is the start of an hour
+        // and processes its tick if process_tick is set
+        template <typename Clock_Controller>
+        static void process_stage(Clock_Controller &clock_controller, const uint8_t stage_bit, const bool process_tick,
+                                  const DCF77_Encoder &now, const uint8_t tick_value) {
+            if (stage_bit > 1) {
+                successors::process_stage(clock_controller, stage_bit >> 1, process_tick, now, tick_value);
+                return;
+            }
+            if (now.second == 0 && now.minute.val == 0x00) {
+                stage::advance(clock_controller, now);
+            }
+            if (process_tick) {
+                stage::get(clock_controller).process_tick(now.second, tick_value);
+            }
+        }
+
+        template <typename Clock_Controller>
+        static void set_DCF77_Encoder(Clock_Controller &clock_controller, DCF77_Encoder &now) {
+            stage::get(clock_controller).set_DCF77_Encoder(now);
+            successors::set_DCF77_Encoder(clock_controller, now);
+        }
+
+        template <typename Clock_Controller>
+        static void setup(Clock_Controller &clock_controller) {
+            stage::setup(clock_controller);
+            successors::setup(clock_controller);
+        }
+
+        // reset_successors is true if any predecessor was reset or has quality factor 0
+        template <typename Clock_Controller>
+        static void sync_lost(Clock_Controller &clock_controller, const bool reset_successors) {
+            successors::sync_lost(clock_controller, stage::sync_lost(clock_controller, reset_successors));
+        }
+    };
+
+    template <typename Configuration_T, typename Frequency_Control_T>
     struct DCF77_Clock_Controller {
         typedef Configuration_T Configuration;
 
-        static DCF77_Second_Decoder  Second_Decoder;
-        static DCF77_Minute_Decoder  Minute_Decoder;
-        static DCF77_Hour_Decoder    Hour_Decoder;
-        static DCF77_Weekday_Decoder Weekday_Decoder;
-        static DCF77_Day_Decoder     Day_Decoder;
-        static DCF77_Month_Decoder   Month_Decoder;
-        static DCF77_Year_Decoder    Year_Decoder;
-        static DCF77_Flag_Decoder    Flag_Decoder;
+        // All state is held per instance. Thus any number of clock controllers
+        // may be run side by side, e.g. one per thread in a simulation.
+        // Configuration::decode_date == false --> the date decoders are replaced by null decoders
+        typedef typename TMP::if_t<Configuration::decode_date, DCF77_Weekday_Decoder,
+                                   DCF77_Null_Decoder<&DCF77_Encoder::weekday> >::type Weekday_Decoder_t;
+        typedef typename TMP::if_t<Configuration::decode_date, DCF77_Day_Decoder,
+                                   DCF77_Null_Decoder<&DCF77_Encoder::day> >::type     Day_Decoder_t;
+        typedef typename TMP::if_t<Configuration::decode_date, DCF77_Month_Decoder,
+                                   DCF77_Null_Decoder<&DCF77_Encoder::month> >::type   Month_Decoder_t;
+        typedef typename TMP::if_t<Configuration::decode_date, DCF77_Year_Decoder,
+                                   DCF77_Null_Decoder<&DCF77_Encoder::year> >::type    Year_Decoder_t;
+
+        DCF77_Second_Decoder  Second_Decoder;
+        DCF77_Minute_Decoder  Minute_Decoder;
+        DCF77_Hour_Decoder    Hour_Decoder;
+        Weekday_Decoder_t     Weekday_Decoder;
+        Day_Decoder_t         Day_Decoder;
+        Month_Decoder_t       Month_Decoder;
+        Year_Decoder_t        Year_Decoder;
+        DCF77_Flag_Decoder    Flag_Decoder;
+
+        // The decoders after the minute decoder. They run only if the minute
+        // decoder has an acceptable quality. Their order is the order of the
+        // resets on sync loss. The null decoders of the date never advance.
+        typedef Decoder_Pipeline<
+            Decoder_Stage<DCF77_Clock_Controller, DCF77_Flag_Decoder, &DCF77_Clock_Controller::Flag_Decoder,
+                          never_advance, never_reset>,
+            Decoder_Stage<DCF77_Clock_Controller, DCF77_Hour_Decoder, &DCF77_Clock_Controller::Hour_Decoder,
+                          follow_hour, reset_and_gate>,
+            Decoder_Stage<DCF77_Clock_Controller, Weekday_Decoder_t,  &DCF77_Clock_Controller::Weekday_Decoder,
+                          Configuration::decode_date? count_weekday: never_advance, reset_only>,
+            Decoder_Stage<DCF77_Clock_Controller, Day_Decoder_t,      &DCF77_Clock_Controller::Day_Decoder,
+                          Configuration::decode_date? follow_day: never_advance, reset_and_gate>,
+            Decoder_Stage<DCF77_Clock_Controller, Month_Decoder_t,    &DCF77_Clock_Controller::Month_Decoder,
+                          Configuration::decode_date? count_month: never_advance, reset_and_gate>,
+            Decoder_Stage<DCF77_Clock_Controller, Year_Decoder_t,     &DCF77_Clock_Controller::Year_Decoder,
+                          Configuration::decode_date? count_year: never_advance, reset_only>
+        > Decoders;
 
         // blocking, will unblock at the start of the second
-        static void get_current_time(DCF77_Encoder &now) {
+        void get_current_time(DCF77_Encoder &now) {
             Local_Clock.get_current_time(now);
         }
 
-        static void set_DCF77_Encoder(DCF77_Encoder &now) {
+        // non-blocking, succeeds once per second at the start of the second
+        bool try_get_current_time(DCF77_Encoder &now) {
+            return Local_Clock.try_get_current_time(now);
+        }
+
+        void set_DCF77_Encoder(DCF77_Encoder &now) {
             now.second  = Second_Decoder.get_time_value();
             now.minute  = Minute_Decoder.get_time_value();
-            now.hour    = Hour_Decoder.get_time_value();
-            now.weekday = Weekday_Decoder.get_time_value();
-            now.day     = Day_Decoder.get_time_value();
-            now.month   = Month_Decoder.get_time_value();
-            now.year    = Year_Decoder.get_time_value();
-
-            now.abnormal_transmitter_operation = Flag_Decoder.get_abnormal_transmitter_operation();
-            now.timezone_change_scheduled      = Flag_Decoder.get_timezone_change_scheduled();
-            now.uses_summertime                = Flag_Decoder.get_uses_summertime();
-            now.leap_second_scheduled          = Flag_Decoder.get_leap_second_scheduled();
+            Decoders::set_DCF77_Encoder(*this, now);
         }
 
-        static uint8_t leap_second;
-        static DCF77_Encoder decoded_time;
-        static void flush() {
+        uint8_t leap_second = 0;
+        DCF77_Encoder decoded_time = DCF77_Encoder();
+        void flush() {
+            DCF77_MARK_TICK_PATH(flush);
+            complete_pending_work();
+
             // This is called "at the end of each second / before the next second begins."
             // The call is triggered by the decoder stages. Thus it flushes the current
             // decoded time. If the decoders are out of sync this may not be
@@ -1924,15 +3319,54 @@ namespace Internal {
             }
 
             // pass control to local clock
-            Local_Clock.process_1_Hz_tick(decoded_time);
+            Local_Clock.process_1_Hz_tick(*this, decoded_time);
         }
 
-        static Clock::output_handler_t output_handler; //= 0;
-        static void set_output_handler(const Clock::output_handler_t new_output_handler) {
+        Frequency_Control_T Frequency_Control;
+
+        Clock::output_handler_t output_handler = 0;
+        void set_output_handler(const Clock::output_handler_t new_output_handler) {
             output_handler = new_output_handler;
         }
 
-        static void local_clock_flush(const DCF77_Encoder &decoded_time) {
+        // Snapshots of the complete state. All state of the controller and its stages
+        // is plain data without any pointers except for the output handler. Hence a
+        // snapshot is just a copy of the controller's memory prefixed by its size.
+        // Obviously a snapshot can only be restored by the very same build of the
+        // very same controller type. The size prefix catches the most likely mismatches.
+        static const uint16_t snapshot_size = sizeof(uint16_t) + sizeof(DCF77_Clock_Controller);
+
+        void save_snapshot(uint8_t *snapshot) const {
+            const uint16_t state_size = sizeof(DCF77_Clock_Controller);
+            snapshot[0] = state_size & 0xFF;
+            snapshot[1] = state_size >> 8;
+
+            const uint8_t *state = (const uint8_t *)this;
+            for (uint16_t i = 0; i < state_size; ++i) {
+                snapshot[sizeof(uint16_t) + i] = state[i];
+            }
+        }
+
+        // Returns false and keeps the current state if the snapshot does not fit.
+        // The output handler is not part of the state, the current one is kept.
+        bool restore_snapshot(const uint8_t *snapshot) {
+            const uint16_t state_size = sizeof(DCF77_Clock_Controller);
+            if (snapshot[0] != (state_size & 0xFF) || snapshot[1] != (state_size >> 8)) {
+                return false;
+            }
+
+            const Clock::output_handler_t current_output_handler = output_handler;
+            uint8_t *state = (uint8_t *)this;
+            for (uint16_t i = 0; i < state_size; ++i) {
+                state[i] = snapshot[sizeof(uint16_t) + i];
+            }
+            output_handler = current_output_handler;
+            return true;
+        }
+
+        void local_clock_flush(const DCF77_Encoder &decoded_time) {
+            DCF77_MARK_TICK_PATH(local_clock_flush);
+
             // This is the callback for the "local clock".
             // It will be called once per second.
 
@@ -1941,7 +3375,10 @@ namespace Internal {
 
             // frequency control must be handled before output handling, otherwise
             // output handling might introduce undesirable jitter to frequency control
-            Frequency_Control::process_1_Hz_tick(decoded_time);
+            if (Frequency_Control.process_1_Hz_tick(decoded_time)) {
+                frequency_adjusted = true;
+                on_tuned_clock();
+            }
 
             if (output_handler) {
                 Clock::time_t time;
@@ -1962,7 +3399,13 @@ namespace Internal {
             if (decoded_time.second == 15 && Local_Clock.clock_state != Clock::useless
                                           && Local_Clock.clock_state != Clock::dirty
             ) {
-                Second_Decoder.set_convolution_time(decoded_time);
+                if (Configuration::amortize_1_Hz_work) {
+                    complete_pending_work();
+                    pending_time = decoded_time;
+                    pending_work = convolution_slice;
+                } else {
+                    Second_Decoder.set_convolution_time(decoded_time);
+                }
             }
         }
 
@@ -1970,18 +3413,250 @@ namespace Internal {
         // the idea is that the input provider and the 1 kHz generator
         // both basically belong to "the hardware". Thus the clock
         // controller will not care to much about them.
-        static void process_1_kHz_tick_data(const uint8_t sampled_data) {
-            Demodulator.detector(sampled_data);
-            Local_Clock.process_1_kHz_tick();
-            Frequency_Control::process_1_kHz_tick();
+        void process_1_kHz_tick_data(const uint8_t sampled_data) {
+            Demodulator.detector(*this, sampled_data);
+            Local_Clock.process_1_kHz_tick(*this);
+            Frequency_Control.process_1_kHz_tick();
+
+            if (Configuration::amortize_1_Hz_work && pending_work != no_pending_work) {
+                process_work_slice();
+            }
+        }
+
+        // set by local_clock_flush, evaluated by the block API below
+        bool frequency_adjusted = false;
+
+        static uint8_t get_sample(const uint64_t *packed_samples, const uint32_t sample) {
+            return (packed_samples[sample / 64] >> (sample % 64)) & 1;
+        }
+
+        static uint16_t get_bin(const uint64_t *packed_samples, const uint32_t sample) {
+            const uint8_t samples_per_bin = DCF77_Demodulator<DCF77_Clock_Controller>::samples_per_bin;
+            const uint8_t shift = sample % 64;
+
+            uint64_t bits = packed_samples[sample / 64] >> shift;
+            if (shift + samples_per_bin > 64) {
+                // the bin spans two words
+                bits |= packed_samples[sample / 64 + 1] << (64 - shift);
+            }
+            return bits & ((1 << samples_per_bin) - 1);
+        }
+
+        // Processes the samples of one bin, the first sample in the least significant
+        // bit. Must only be called if Demodulator.is_at_bin_start(). The demodulator
+        // does nothing but averaging until the last sample of a bin. Hence the local
+        // clock may run ahead. Returns the number of processed samples, this is less
+        // than samples_per_bin only if the frequency was adjusted.
+        uint8_t process_bin(const uint16_t samples) {
+            const uint8_t samples_per_bin = DCF77_Demodulator<DCF77_Clock_Controller>::samples_per_bin;
+
+            // quiet ticks will not adjust the frequency, hence they are processed at once
+            uint8_t bin_sample = min((uint16_t)(samples_per_bin - 1), Local_Clock.get_quiet_ticks());
+            Local_Clock.process_1_kHz_ticks(bin_sample);
+            Frequency_Control.process_1_kHz_ticks(bin_sample);
+            while (bin_sample < samples_per_bin - 1 && !frequency_adjusted) {
+                Local_Clock.process_1_kHz_tick(*this);
+                Frequency_Control.process_1_kHz_tick();
+                ++bin_sample;
+            }
+            process_work_slices(bin_sample);
+
+            if (frequency_adjusted) {
+                // catch up with the averaging for the samples processed so far
+                for (uint8_t i = 0; i < bin_sample; ++i) {
+                    Demodulator.detector(*this, (samples >> i) & 1);
+                }
+                return bin_sample;
+            }
+
+            Demodulator.detector_bin(*this, samples);
+            Local_Clock.process_1_kHz_tick(*this);
+            Frequency_Control.process_1_kHz_tick();
+            process_work_slices(1);
+            return samples_per_bin;
+        }
+
+        // Block counterpart of process_1_kHz_tick_data. The samples are packed 64 per
+        // word, the first sample in the least significant bit. This allows to feed
+        // the clock from a DMA or timer capture buffer instead of a 1 kHz interrupt.
+        // The results are exactly the same as for calling process_1_kHz_tick_data
+        // for each sample. However the demodulator averages whole bins at once.
+        //
+        // If the frequency control adjusts the clock, processing stops right after
+        // the sample that triggered the adjustment. This is because the remaining
+        // samples were taken at the old rate. Whoever provides the samples must
+        // apply the new adjustment and then pass the remaining samples again.
+        // Returns the number of processed samples.
+        uint32_t process_1_kHz_tick_data(const uint64_t *packed_samples, const uint32_t sample_count) {
+            const uint8_t samples_per_bin = DCF77_Demodulator<DCF77_Clock_Controller>::samples_per_bin;
+
+            frequency_adjusted = false;
+            uint32_t sample = 0;
+            while (sample < sample_count && !frequency_adjusted) {
+                if (samples_per_bin > 1 && Demodulator.is_at_bin_start() && sample_count - sample >= samples_per_bin) {
+                    sample += process_bin(get_bin(packed_samples, sample));
+                } else {
+                    process_1_kHz_tick_data(get_sample(packed_samples, sample));
+                    ++sample;
+                }
+            }
+            return sample;
+        }
+
+        // Constant run counterpart of process_1_kHz_tick_data. Processes sample_count
+        // samples which all have the value sampled_data. About 80-90% of each second
+        // are constant. Hence replaying recorded or synthesized signals is dominated
+        // by such runs. As long as neither the demodulator nor the local clock will
+        // trigger any events all bins are processed in a tight loop and the local
+        // clock and frequency control are advanced in one go. The results are exactly
+        // the same as for calling process_1_kHz_tick_data for each sample.
+        // Just like the block API it stops right after a frequency adjustment and
+        // returns the number of processed samples.
+        uint32_t process_1_kHz_tick_data_run(const uint8_t sampled_data, const uint32_t sample_count) {
+            const uint8_t samples_per_bin = DCF77_Demodulator<DCF77_Clock_Controller>::samples_per_bin;
+
+            // the average of identical samples is the sample value
+            const uint8_t input = samples_per_bin > 1? sampled_data != 0: sampled_data;
+
+            frequency_adjusted = false;
+            uint32_t sample = 0;
+            while (sample < sample_count && !frequency_adjusted) {
+                if (Demodulator.is_at_bin_start()) {
+                    const uint32_t max_samples = min(sample_count - sample, (uint32_t)Local_Clock.get_quiet_ticks());
+                    const uint16_t samples = Demodulator.detector_run(input, max_samples / samples_per_bin) * samples_per_bin;
+                    if (samples > 0) {
+                        Local_Clock.process_1_kHz_ticks(samples);
+                        Frequency_Control.process_1_kHz_ticks(samples);
+                        process_work_slices(samples);
+                        sample += samples;
+                        continue;
+                    }
+
+                    if (samples_per_bin > 1 && sample_count - sample >= samples_per_bin) {
+                        // the next bin will trigger some event, still it is a constant bin
+                        sample += process_bin(input? (1 << samples_per_bin) - 1: 0);
+                        continue;
+                    }
+                }
+
+                // the run started within a bin, the samples before its last one are only averaged
+                uint32_t samples = min(sample_count - sample, (uint32_t)Local_Clock.get_quiet_ticks());
+                Arithmetic_Tools::minimize(samples, (uint32_t)Demodulator.samples_before_bin_end());
+                if (samples > 0) {
+                    Demodulator.detector_samples(sampled_data, samples);
+                    Local_Clock.process_1_kHz_ticks(samples);
+                    Frequency_Control.process_1_kHz_ticks(samples);
+                    process_work_slices(samples);
+                    sample += samples;
+                    continue;
+                }
+
+                process_1_kHz_tick_data(sampled_data);
+                ++sample;
+            }
+            return sample;
+        }
+
+        // Amortized 1 Hz work (Configuration::amortize_1_Hz_work)
+        //
+        // Instead of running the decoder cascade and set_convolution_time right away
+        // they are queued. Each following 1 kHz tick processes one slice, i.e. the
+        // second decoder, the minute decoder or one stage of the decoder pipeline.
+        // The slices only touch the decoders. Hence the only thing that matters is
+        // that everything that reads or resets the decoders completes the pending
+        // slices first. These are flush(), the next process_single_tick_data() and
+        // the event handlers. Thus the results are exactly the same as without
+        // amortization. At most one second's work is pending at any time.
+        enum work_slice_t : uint8_t {
+            no_pending_work = 0,
+            convolution_slice,
+            second_slice,
+            minute_slice,
+            stage_slice        // the lowest of the pending_stages
+        };
+        work_slice_t pending_work = no_pending_work;
+        // the convolution time or the time which is decoded right now
+        DCF77_Encoder pending_time = DCF77_Encoder();
+        DCF77::tick_t pending_tick_data = DCF77::undefined;
+        // the stage bits of the pipeline that still have to advance or process their tick
+        uint8_t pending_stages = 0;
+        // the stage bits that process their tick
+        uint8_t pending_tick_stages = 0;
+
+        // Processes the next slice of the pending work. Returns immediately if there is none.
+        void process_work_slice() {
+            DCF77_MARK_TICK_PATH(work_slice);
+            using namespace DCF77;
+
+            const DCF77_Encoder &now = pending_time;
+            const uint8_t tick_value = (pending_tick_data == long_tick || pending_tick_data == undefined)? 1: 0;
+
+            switch (pending_work) {
+                case no_pending_work:
+                    return;
+
+                case convolution_slice:
+                    Second_Decoder.set_convolution_time(now);
+                    pending_work = no_pending_work;
+                    return;
+
+                case second_slice:
+                    Second_Decoder.binning(pending_tick_data);
+                    pending_work = minute_slice;
+                    return;
+
+                case minute_slice:
+                    if (now.second == 0) {
+                        Minute_Decoder.advance_tick();
+                    }
+                    Minute_Decoder.process_tick(now.second, tick_value);
+                    pending_tick_stages =
+                        Minute_Decoder.get_quality_factor() > Configuration::unacceptable_minute_decoder_quality?
+                            Decoders::get_stages(now.second): 0;
+                    // the advances must be processed even if the minute quality is not ok
+                    pending_stages = pending_tick_stages |
+                        ((now.second == 0 && now.minute.val == 0x00)? Decoders::get_advancing_stages(): 0);
+                    pending_work = pending_stages? stage_slice: no_pending_work;
+                    return;
+
+                case stage_slice: {
+                    const uint8_t stage_bit = pending_stages & -pending_stages;
+                    Decoders::process_stage(*this, stage_bit, pending_tick_stages & stage_bit, now, tick_value);
+                    pending_stages -= stage_bit;
+                    pending_work = pending_stages? stage_slice: no_pending_work;
+                    return;
+                }
+            }
+        }
+
+        void complete_pending_work() {
+            if (Configuration::amortize_1_Hz_work) {
+                while (pending_work != no_pending_work) {
+                    process_work_slice();
+                }
+            }
+        }
+
+        // The slices of ticks that the run and block APIs process at once.
+        // Just like single ticks each of them processes one slice.
+        void process_work_slices(uint32_t ticks) {
+            if (Configuration::amortize_1_Hz_work) {
+                while (ticks > 0 && pending_work != no_pending_work) {
+                    process_work_slice();
+                    --ticks;
+                }
+            }
         }
 
         // This is the callback of the Demodulator stage. The clock controller
         // assumes that this is called more or less once per second by the demodulator.
         // However it is understood that this may jitter depending on the signal quality.
-        static void process_single_tick_data(const DCF77::tick_t tick_data) {
+        void process_single_tick_data(const DCF77::tick_t tick_data) {
+            DCF77_MARK_TICK_PATH(decode);
             using namespace DCF77;
 
+            complete_pending_work();
+
             DCF77_Encoder now;
             set_DCF77_Encoder(now);
             now.second += leap_second;
@@ -1994,50 +3669,27 @@ namespace Internal {
             leap_second += (now.second == 59 && now.get_current_signal() != sync_mark);
 
             if (leap_second != 1) {
+                if (Configuration::amortize_1_Hz_work) {
+                    pending_time = now;
+                    pending_tick_data = tick_data;
+                    pending_work = second_slice;
+                    return;
+                }
+
                 Second_Decoder.binning(tick_data);
 
                 if (now.second == 0) {
                     Minute_Decoder.advance_tick();
                     if (now.minute.val == 0x00) {
-
-                        // "while" takes automatically care of timezone change
-                        while (Hour_Decoder.get_time_value().val <= 0x23 &&
-                            Hour_Decoder.get_time_value().val != now.hour.val) {
-                            Hour_Decoder.advance_tick();
-                        }
-
-                        if (now.hour.val == 0x00) {
-                            if (Weekday_Decoder.get_time_value().val <= 0x07) {
-                                Weekday_Decoder.advance_tick();
-                            }
-
-                            // "while" takes automatically care of different month lengths
-                            while (Day_Decoder.get_time_value().val <= 0x31 &&
-                                Day_Decoder.get_time_value().val != now.day.val) {
-                                Day_Decoder.advance_tick();
-                            }
-
-                            if (now.day.val == 0x01) {
-                                if (Month_Decoder.get_time_value().val <= 0x12) {
-                                    Month_Decoder.advance_tick();
-                                }
-                                if (now.month.val == 0x01) {
-                                    if (now.year.val <= 0x99) { Year_Decoder.advance_tick(); }
-                                }
-                            }
-                        }
+                        Decoders::advance(*this, now);
                     }
                 }
 
                 const uint8_t tick_value = (tick_data == long_tick || tick_data == undefined)? 1: 0;
                 Minute_Decoder.process_tick(now.second, tick_value);
-                if (Minute_Decoder.get_quality_factor() > Configuration::unacceptable_minute_decoder_quality) {
-                    Flag_Decoder.process_tick(now.second, tick_value);
-                    Hour_Decoder.process_tick(now.second, tick_value);
-                    Weekday_Decoder.process_tick(now.second, tick_value);
-                    Day_Decoder.process_tick(now.second, tick_value);
-                    Month_Decoder.process_tick(now.second, tick_value);
-                    Year_Decoder.process_tick(now.second, tick_value);
+                const uint8_t stages = Decoders::get_stages(now.second);
+                if (stages && Minute_Decoder.get_quality_factor() > Configuration::unacceptable_minute_decoder_quality) {
+                    Decoders::process_tick(*this, stages, now.second, tick_value);
                 }
             }
         }
@@ -2063,7 +3715,7 @@ namespace Internal {
             uint8_t leap_second_scheduled_quality;
         } clock_quality_t;
 
-        static void get_quality(clock_quality_t &clock_quality) {
+        void get_quality(clock_quality_t &clock_quality) {
             Demodulator.get_quality(clock_quality.phase);
             Second_Decoder.get_quality(clock_quality.second);
             Minute_Decoder.get_quality(clock_quality.minute);
@@ -2089,7 +3741,7 @@ namespace Internal {
             uint8_t year;
         } clock_quality_factor_t;
 
-        static void get_quality_factor(clock_quality_factor_t &clock_quality_factor) {
+        void get_quality_factor(clock_quality_factor_t &clock_quality_factor) {
             clock_quality_factor.phase   = Demodulator.get_quality_factor();
             clock_quality_factor.second  = Second_Decoder.get_quality_factor();
             clock_quality_factor.minute  = Minute_Decoder.get_quality_factor();
@@ -2100,13 +3752,50 @@ namespace Internal {
             clock_quality_factor.year    = Year_Decoder.get_quality_factor();
         }
 
-        static uint8_t get_overall_quality_factor() {
+        // The weekday computed for the last date that get_overall_quality_factor
+        // checked. It changes at most once per second, so it is cached.
+        bool weekday_check_valid = false;
+        BCD::bcd_t weekday_check_day;
+        BCD::bcd_t weekday_check_month;
+        BCD::bcd_t weekday_check_year;
+        BCD::bcd_t weekday_check_weekday;
+
+        BCD::bcd_t get_weekday_of(const BCD::bcd_t day, const BCD::bcd_t month, const BCD::bcd_t year) {
+            CRITICAL_SECTION {
+                if (weekday_check_valid &&
+                    weekday_check_day.val == day.val &&
+                    weekday_check_month.val == month.val &&
+                    weekday_check_year.val == year.val) {
+                    return weekday_check_weekday;
+                }
+            }
+
+            DCF77_Encoder now;
+            now.day   = day;
+            now.month = month;
+            now.year  = year;
+            const BCD::bcd_t weekday = now.get_bcd_weekday();
+
+            CRITICAL_SECTION {
+                weekday_check_valid = true;
+                weekday_check_day = day;
+                weekday_check_month = month;
+                weekday_check_year = year;
+                weekday_check_weekday = weekday;
+            }
+            return weekday;
+        }
+
+        uint8_t get_overall_quality_factor() {
             using namespace Arithmetic_Tools;
 
             uint8_t quality_factor = Demodulator.get_quality_factor();
             minimize(quality_factor, Second_Decoder.get_quality_factor());
             minimize(quality_factor, Minute_Decoder.get_quality_factor());
             minimize(quality_factor, Hour_Decoder.get_quality_factor());
+            if (!Configuration::decode_date) {
+                return quality_factor;
+            }
 
             uint8_t date_quality_factor = Day_Decoder.get_quality_factor();
             minimize(date_quality_factor, Month_Decoder.get_quality_factor());
@@ -2114,18 +3803,10 @@ namespace Internal {
 
             const uint8_t weekday_quality_factor = Weekday_Decoder.get_quality_factor();
             if (date_quality_factor > 0 && weekday_quality_factor > 0) {
-
-                DCF77_Encoder now;
-                now.second  = Second_Decoder.get_time_value();
-                now.minute  = Minute_Decoder.get_time_value();
-                now.hour    = Hour_Decoder.get_time_value();
-                now.weekday = Weekday_Decoder.get_time_value();
-                now.day     = Day_Decoder.get_time_value();
-                now.month   = Month_Decoder.get_time_value();
-                now.year    = Year_Decoder.get_time_value();
-
-                BCD::bcd_t weekday = now.get_bcd_weekday();
-                if (now.weekday.val == weekday.val) {
+                const BCD::bcd_t weekday = get_weekday_of(Day_Decoder.get_time_value(),
+                                                          Month_Decoder.get_time_value(),
+                                                          Year_Decoder.get_time_value());
+                if (Weekday_Decoder.get_time_value().val == weekday.val) {
                     date_quality_factor += 1;
                 } else if (date_quality_factor <= weekday_quality_factor) {
                     date_quality_factor = 0;
@@ -2136,15 +3817,15 @@ namespace Internal {
             return quality_factor;
         };
 
-        static Clock::clock_state_t get_clock_state() {
+        Clock::clock_state_t get_clock_state() {
             return Local_Clock.get_state();
         }
 
-        static uint8_t get_prediction_match() {
+        uint8_t get_prediction_match() {
             return Second_Decoder.get_prediction_match();
         }
 
-        static void on_tuned_clock() {
+        void on_tuned_clock() {
             if (Configuration::has_stable_ambient_temperature) {
                 // If ambient temperature is not stable tuning
                 // the crystal is no guarantee for reasonable
@@ -2156,7 +3837,10 @@ namespace Internal {
             }
         };
 
-        static void phase_lost_event_handler() {
+        void phase_lost_event_handler() {
+            DCF77_MARK_TICK_PATH(phase_lost);
+            complete_pending_work();
+
             // do not reset frequency control as a reset would also reset
             // the current value for the measurement period length
 
@@ -2168,14 +3852,10 @@ namespace Internal {
 
             Second_Decoder.setup();
             Minute_Decoder.setup();
-            Hour_Decoder.setup();
-            Day_Decoder.setup();
-            Weekday_Decoder.setup();
-            Month_Decoder.setup();
-            Year_Decoder.setup();
+            Decoders::setup(*this);
         }
 
-        static void sync_achieved_event_handler() {
+        void sync_achieved_event_handler() {
             // It can be argued if phase events instead of sync events
             // should be used. In theory it would be sufficient to have a
             // reasonable phase at the start and end of a calibration measurement
@@ -2183,11 +3863,14 @@ namespace Internal {
             // On the other hand a clean signal will provide a better calibration.
             // Since it is sufficient if the calibration happens only once in a
             // while we are satisfied with hooking at the sync events.
-            Frequency_Control::qualify_calibration();
+            Frequency_Control.qualify_calibration();
         }
 
-        static void sync_lost_event_handler() {
-            Frequency_Control::unqualify_calibration();
+        void sync_lost_event_handler() {
+            DCF77_MARK_TICK_PATH(sync_lost);
+            complete_pending_work();
+
+            Frequency_Control.unqualify_calibration();
 
             bool reset_successors = (Demodulator.get_quality_factor() == 0);
             if (reset_successors) {
@@ -2200,47 +3883,46 @@ namespace Internal {
             }
 
             reset_successors |= (Minute_Decoder.get_quality_factor() == 0);
-            if (reset_successors) {
-                Hour_Decoder.setup();
-            }
-
-            reset_successors |= (Hour_Decoder.get_quality_factor() == 0);
-            if (reset_successors) {
-                Weekday_Decoder.setup();
-                Day_Decoder.setup();
-            }
-
-            reset_successors |= (Day_Decoder.get_quality_factor() == 0);
-            if (reset_successors) {
-                Month_Decoder.setup();
-            }
-
-            reset_successors |= (Month_Decoder.get_quality_factor() == 0);
-            if (reset_successors) {
-                Year_Decoder.setup();
-            }
+            Decoders::sync_lost(*this, reset_successors);
         }
 
-        static DCF77_Demodulator<DCF77_Clock_Controller> Demodulator;
-        static uint8_t get_demodulator_quality_factor() {
+        DCF77_Demodulator<DCF77_Clock_Controller> Demodulator;
+        uint8_t get_demodulator_quality_factor() {
             return Demodulator.get_quality_factor();
         }
 
-        static DCF77_Local_Clock<DCF77_Clock_Controller> Local_Clock;
+        DCF77_Local_Clock<DCF77_Clock_Controller> Local_Clock;
 
         // non-blocking, reads current second
-        static void read_current_time(DCF77_Encoder &now) {
+        void read_current_time(DCF77_Encoder &now) {
             Local_Clock.read_current_time(now);
         }
 
-        static void setup() {
+        // non-blocking, reads current second and the milliseconds since its start
+        void read_current_time(DCF77_Encoder &now, uint16_t &millisecond) {
+            Local_Clock.read_current_time(now, millisecond);
+        }
+
+        // same but lock free only, may be called from interrupts
+        bool try_read_current_time(DCF77_Encoder &now, uint16_t &millisecond) {
+            return Local_Clock.try_read_current_time(now, millisecond);
+        }
+
+        // non-blocking, disciplined 1 kHz ticks since setup
+        uint64_t get_monotonic_milliseconds() {
+            return Local_Clock.read_milliseconds();
+        }
+
+        void setup() {
+            pending_work = no_pending_work;
             Demodulator.setup();
             phase_lost_event_handler();
-            Frequency_Control::setup();
+            Flag_Decoder.setup();
+            Frequency_Control.setup();
             Local_Clock.setup();
         }
 
-        static void debug() {
+        void debug() {
             DCF77_Encoder now;
             now.second  = Second_Decoder.get_time_value();
             now.minute  = Minute_Decoder.get_time_value();
@@ -2337,18 +4019,224 @@ namespace Internal {
         }
     };
 
-    namespace Generic_1_kHz_Generator {
-        // This is the only remaining dependency to the DCF77 clock.
-        // The implementation of the generator is otherwise completely generic.
-        typedef DCF77_Clock_Controller<Configuration, DCF77_Frequency_Control> Clock_Controller;
+    // Single producer single consumer queue for Configuration::deferred_processing.
+    // The 1 kHz interrupt pushes the samples and packs 8 of them into one byte. The
+    // main loop pops the bytes. Only the producer writes head, only the consumer
+    // writes tail. Both are single bytes, hence reads and writes are atomic even
+    // on AVR. If the queue is full the samples are dropped and counted.
+    template <uint8_t queue_bytes>
+    struct Sample_Queue {
+        static_assert(queue_bytes > 1 && (queue_bytes & (queue_bytes - 1)) == 0,
+                      "queue_bytes must be a power of 2");
+        static const uint8_t index_mask = queue_bytes - 1;
+
+        volatile uint8_t data[queue_bytes];
+        volatile uint8_t head = 0;  // next byte to write
+        volatile uint8_t tail = 0;  // next byte to read
+
+        // producer only
+        uint8_t pending_samples = 0;
+        uint8_t pending_count = 0;
+        volatile uint32_t lost_samples = 0;
+        volatile uint8_t max_queued_bytes = 0;
+
+        void setup() {
+            head = 0;
+            tail = 0;
+            pending_samples = 0;
+            pending_count = 0;
+            lost_samples = 0;
+            max_queued_bytes = 0;
+        }
+
+        void push(const uint8_t sample) {
+            pending_samples |= (sample != 0) << pending_count;
+            ++pending_count;
+            if (pending_count < 8) { return; }
+
+            const uint8_t next_head = (head + 1) & index_mask;
+            if (next_head == tail) {
+                lost_samples += 8;
+            } else {
+                data[head] = pending_samples;
+                // data must be written before head
+                head = next_head;
+
+                const uint8_t queued_bytes = (next_head - tail) & index_mask;
+                if (queued_bytes > max_queued_bytes) { max_queued_bytes = queued_bytes; }
+            }
+            pending_samples = 0;
+            pending_count = 0;
+        }
+
+        // Returns false if the queue is empty. Otherwise samples holds 8 samples,
+        // the first one in the least significant bit.
+        bool pop(uint8_t &samples) {
+            const uint8_t current_tail = tail;
+            if (current_tail == head) { return false; }
+
+            samples = data[current_tail];
+            // data must be read before tail is released
+            tail = (current_tail + 1) & index_mask;
+            return true;
+        }
+    };
+
+    // Hashed timer wheel for DCF77_Clock::schedule. Timers are keyed by an
+    // instant that orders local times, including the repeated hour when summer
+    // time ends. The second wheel is visited once per second, it holds the
+    // timers of the future seconds. Timers that are due in the current second
+    // move to the millisecond wheel which is visited once per tick. Timers
+    // that are due are unlinked before their actions are called. Thus actions
+    // may schedule or cancel any timers. Without armed timers the scheduler
+    // does not run at all, hence it costs nothing if schedule is never used.
+    struct DCF77_Scheduler {
+        static const uint8_t second_slots = 8;
+        static const uint8_t millisecond_slots = 8;
+        static const uint8_t due_slot = second_slots + millisecond_slots;
+        static const uint8_t not_armed = 0xff;
+
+        Clock::timer_t *slots[due_slot + 1];
+
+        // timers are armed by schedule and disarmed by cancel or when they fire
+        uint16_t armed_timers;
+
+        bool running;
+        uint8_t time_sequence;
+        uint16_t current_millisecond;
+        uint64_t current_instant;
+        // the expected time of the next second, anything else is a discontinuity
+        DCF77_Encoder next_time;
+
+        static uint64_t get_instant(const Clock::time_t &time);
+        static uint64_t get_instant(const DCF77_Encoder &time);
+
+        void setup();
+        void link(Clock::timer_t &timer, const uint8_t slot);
+        void unlink(Clock::timer_t &timer);
+        // links the timer to the slot that matches its instant
+        void arm(Clock::timer_t &timer);
+
+        void schedule(Clock::timer_t &timer, const uint64_t instant, const uint16_t millisecond,
+                      const Clock::timer_action_t action);
+        void cancel(Clock::timer_t &timer);
+
+        void process_second_slot(const uint8_t slot);
+        void process_millisecond_slot(const uint8_t slot);
+        void process_due_timers();
+        void process_1_kHz_tick(const Clock::clock_state_t clock_state, const uint8_t new_time_sequence,
+                                const DCF77_Encoder &now, const uint16_t millisecond);
+    };
 
+    namespace Generic_1_kHz_Generator {
         void setup(const Clock::input_provider_t input_provider);
         uint8_t zero_provider();
         // positive_value --> increase frequency
         // pp16m = parts per 16 million = 1 Hz @ 16 Mhz
         void adjust(const int16_t pp16m);
         int16_t read_adjustment();
+        // the phase deviation that was cumulated since the last timer correction
+        int32_t read_phase_deviation();
+        void set_phase_deviation(const int32_t phase_deviation);
+        // the part of isr_handler that is the same for all platforms
+        void process_sample(const uint8_t sample);
         void isr_handler();
     }
 }
+
+namespace DCF77_Clock {
+    // The functions of DCF77_Clock are thin wrappers around this instance.
+    // It is also the instance that gets driven by the 1 kHz generator.
+    typedef Internal::DCF77_Clock_Controller<Configuration, Internal::DCF77_Frequency_Control> Clock_Controller;
+    extern Clock_Controller the_clock_controller;
+
+    // Only used for Configuration::deferred_processing, otherwise it is kept as small as possible.
+    typedef Internal::Sample_Queue<Configuration::deferred_processing? Configuration::deferred_queue_bytes: 2> Sample_Queue;
+    extern Sample_Queue the_sample_queue;
+
+    void convert_time(const Internal::DCF77_Encoder &current_time, Clock::time_t &now);
+
+    extern Internal::DCF77_Scheduler the_scheduler;
+    // runs the scheduler, called after each 1 kHz tick of the_clock_controller
+    void process_timers();
+
+    // Queue for timestamps of external events, e.g. a pin change of a sensor.
+    // capture() may be called from any interrupt. It copies the current time
+    // and the milliseconds since the start of the second into the queue. It
+    // does not disable interrupts and it does not wait. The main loop pops the
+    // events later. If the queue is full the event is dropped and counted.
+    //
+    // Usage:
+    //     DCF77_Clock::Event_Queue<16> events;
+    //     ISR(PCINT0_vect) { events.capture(sensor_id); }
+    //     void loop() {
+    //         Clock::time_t time; uint16_t millisecond; uint8_t tag;
+    //         while (events.pop(time, millisecond, tag)) { ... }
+    //     }
+    //
+    // Captures must not interrupt each other or the 1 kHz interrupt. On AVR
+    // this is always the case, on ARM all capturing interrupts must not have a
+    // higher priority than the 1 kHz interrupt. With
+    // Configuration::deferred_processing the time lags behind by the queued
+    // samples, that is it is not suitable for timestamps. Events that interrupt
+    // poll() while it writes the time are dropped and counted as lost.
+    template <uint8_t queue_size>
+    struct Event_Queue {
+        static_assert(queue_size > 1 && (queue_size & (queue_size - 1)) == 0,
+                      "queue_size must be a power of 2");
+        static const uint8_t index_mask = queue_size - 1;
+
+        struct event_t {
+            Internal::DCF77_Encoder time;
+            uint16_t millisecond;
+            uint8_t tag;
+        };
+
+        event_t events[queue_size];
+        volatile uint8_t head = 0;  // written by capture only
+        volatile uint8_t tail = 0;  // written by pop only
+        volatile uint16_t lost_events = 0;
+
+        // call it from the interrupt, returns false if the event was dropped
+        bool capture(const uint8_t tag) {
+            const uint8_t current_head = head;
+            const uint8_t next_head = (current_head + 1) & index_mask;
+            event_t &event = events[current_head];
+            if (next_head == tail ||
+                !the_clock_controller.try_read_current_time(event.time, event.millisecond)) {
+                if (lost_events < Internal::TMP::limits<uint16_t>::max) { ++lost_events; }
+                return false;
+            }
+            event.tag = tag;
+            // the event must be complete before it is published
+            MEMORY_BARRIER;
+            head = next_head;
+            return true;
+        }
+
+        // call it from the main loop, returns false if the queue is empty
+        bool pop(Clock::time_t &time, uint16_t &millisecond, uint8_t &tag) {
+            const uint8_t current_tail = tail;
+            if (current_tail == head) { return false; }
+
+            MEMORY_BARRIER;
+            const event_t &event = events[current_tail];
+            convert_time(event.time, time);
+            millisecond = event.millisecond;
+            tag = event.tag;
+            MEMORY_BARRIER;
+            tail = (current_tail + 1) & index_mask;
+            return true;
+        }
+
+        // saturates at 65535
+        uint16_t get_lost_events() {
+            uint16_t lost;
+            CRITICAL_SECTION {
+                lost = lost_events;
+            }
+            return lost;
+        }
+    };
+}
 #endif
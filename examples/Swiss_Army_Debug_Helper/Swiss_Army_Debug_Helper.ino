@@ -69,7 +69,7 @@ uint8_t ledpin(const uint8_t led) {
 
 
 using namespace Internal;
-typedef DCF77_Clock_Controller<Configuration, DCF77_Frequency_Control> Clock_Controller;
+DCF77_Clock::Clock_Controller &Clock_Controller = DCF77_Clock::the_clock_controller;
 
 
 namespace Phase_Drift_Analysis {
@@ -221,8 +221,8 @@ namespace LED_Display {
             }
 
             case 'c': { // calibration state + deviation
-                const DCF77_Frequency_Control::calibration_state_t calibration_state = DCF77_Frequency_Control::get_calibration_state();
-                int16_t deviation = abs(DCF77_Frequency_Control::get_current_deviation());
+                const DCF77_Frequency_Control::calibration_state_t calibration_state = Clock_Controller.Frequency_Control.get_calibration_state();
+                int16_t deviation = abs(Clock_Controller.Frequency_Control.get_current_deviation());
                 uint8_t led = lower_output_led;
 
                 // display calibration state, blink if running unqualified
@@ -761,7 +761,7 @@ void loop() {
                 #endif
                 #endif
             }
-            DCF77_Frequency_Control::debug();
+            Clock_Controller.Frequency_Control.debug();
             Phase_Drift_Analysis::debug();
             //DCF77_Demodulator::debug();
             if (mode == 'A') {
@@ -782,7 +782,7 @@ void loop() {
             Clock::time_t now;
             DCF77_Clock::get_current_time(now);
 
-            Clock_Controller::Demodulator.debug();
+            Clock_Controller.Demodulator.debug();
             break;
         }
 
@@ -793,7 +793,7 @@ void loop() {
             print_clock_state();
             Serial.println();
 
-            Clock_Controller::Demodulator.debug_verbose();
+            Clock_Controller.Demodulator.debug_verbose();
             Serial.println();
             break;
         }
@@ -867,8 +867,8 @@ void loop() {
 
             DCF77_Clock::debug();
 
-            //Clock_Controller::Second_Decoder.debug();
-            Clock_Controller::Local_Clock.debug();
+            //Clock_Controller.Second_Decoder.debug();
+            Clock_Controller.Local_Clock.debug();
         }
     }
     //free_dump();
@@ -361,9 +361,8 @@ void loop() {
         DCF77_Clock::debug();
 
         // get access to low level debug information
-        typedef Internal::DCF77_Clock_Controller<Configuration, Internal::DCF77_Frequency_Control> Clock_Controller;
-        //Clock_Controller::Second_Decoder.debug();
-        Clock_Controller::Local_Clock.debug();
+        //DCF77_Clock::the_clock_controller.Second_Decoder.debug();
+        DCF77_Clock::the_clock_controller.Local_Clock.debug();
     }
 
     if (mode == 'd') {
@@ -1327,9 +1327,8 @@ namespace parser {
 }
 
 uint8_t lock_progress() {
-    typedef Internal::DCF77_Clock_Controller<Configuration, Internal::DCF77_Frequency_Control> Clock_Controller;
-    Clock_Controller::clock_quality_factor_t quality;
-    Clock_Controller::get_quality_factor(quality);
+    DCF77_Clock::Clock_Controller::clock_quality_factor_t quality;
+    DCF77_Clock::the_clock_controller.get_quality_factor(quality);
 
     return
         (quality.phase   > 0) +
@@ -775,6 +775,304 @@ void test_Arithmetic_Tools() {
     }
 }
 
+void test_Sample_Queue() {
+    using namespace Internal;
+    {
+        Sample_Queue<4> queue;
+        queue.setup();
+        uint8_t samples = 0;
+        assert(F("empty queue pops nothing"), !queue.pop(samples));
+
+        for (uint8_t i = 0; i < 7; ++i) { queue.push(i & 1); }
+        assert(F("incomplete byte is not published"), !queue.pop(samples));
+
+        queue.push(1);
+        bool ok = queue.pop(samples);
+        assert(F("first sample in least significant bit"), ok && samples == 0xAA, samples);
+        assert(F("popped queue is empty"), !queue.pop(samples));
+    }
+
+    {
+        // 4 bytes, one of them is always kept free
+        Sample_Queue<4> queue;
+        queue.setup();
+        for (uint8_t i = 0; i < 5 * 8; ++i) { queue.push(i < 8); }
+        assert(F("overflow drops and counts samples"), queue.lost_samples == 16, queue.lost_samples);
+        assert(F("max fill is tracked"), queue.max_queued_bytes == 3, queue.max_queued_bytes);
+
+        uint8_t samples = 0;
+        bool ok = queue.pop(samples) && samples == 0xFF;
+        ok = ok && queue.pop(samples) && samples == 0x00;
+        ok = ok && queue.pop(samples) && samples == 0x00;
+        ok = ok && !queue.pop(samples);
+        assert(F("oldest samples survive an overflow"), ok);
+
+        // wrap around
+        for (uint8_t i = 0; i < 8; ++i) { queue.push(1); }
+        ok = queue.pop(samples) && samples == 0xFF;
+        assert(F("queue wraps around"), ok, samples);
+        assert(F("no further samples lost"), queue.lost_samples == 16, queue.lost_samples);
+    }
+}
+
+void test_Event_Queue() {
+    // the tick interrupts are disabled, hence the local clock stands still
+    DCF77_Clock::Event_Queue<4> events;
+    Clock::time_t time;
+    uint16_t millisecond;
+    uint8_t tag;
+    assert(F("empty queue pops nothing"), !events.pop(time, millisecond, tag));
+
+    bool ok = true;
+    for (uint8_t i = 0; i < 3; ++i) { ok = ok && events.capture(i); }
+    assert(F("captures up to queue_size - 1 events"), ok);
+    assert(F("drops events if full"), !events.capture(3) && events.get_lost_events() == 1, events.get_lost_events());
+
+    for (uint8_t i = 0; i < 3; ++i) {
+        ok = ok && events.pop(time, millisecond, tag) && tag == i && millisecond <= 999;
+    }
+    ok = ok && !events.pop(time, millisecond, tag);
+    assert(F("pops events in order"), ok);
+
+    // an interrupt that preempts the write of the milliseconds, e.g. by poll()
+    uint8_t &sequence = (uint8_t &)DCF77_Clock::the_clock_controller.Local_Clock.milliseconds_sequence;
+    ++sequence;
+    assert(F("drops events during a write"), !events.capture(4) && events.get_lost_events() == 2, events.get_lost_events());
+    ++sequence;
+    assert(F("captures again after the write"), events.capture(5) && events.pop(time, millisecond, tag) && tag == 5);
+}
+
+
+namespace Scheduler_Test {
+    // a local scheduler that is driven by a synthetic local clock
+    Internal::DCF77_Scheduler scheduler;
+    Internal::DCF77_Encoder now;
+    uint8_t time_sequence = 0;
+    uint16_t millisecond = 0;
+
+    Clock::timer_t timer_a;
+    Clock::timer_t timer_b;
+
+    uint8_t fired;
+    Internal::DCF77_Encoder fired_time;
+    uint16_t fired_millisecond;
+
+    void record() {
+        ++fired;
+        fired_time = now;
+        fired_millisecond = millisecond;
+    }
+
+    void record_and_cancel_both() {
+        record();
+        scheduler.cancel(timer_a);
+        scheduler.cancel(timer_b);
+    }
+
+    void record_and_reschedule_a() {
+        record();
+        Internal::DCF77_Encoder next = now;
+        next.advance_second();
+        scheduler.schedule(timer_a, Internal::DCF77_Scheduler::get_instant(next), millisecond, record_and_reschedule_a);
+    }
+
+    void setup() {
+        scheduler.setup();
+        now.reset();
+        now.year.val  = 0x09;
+        now.month.val = 0x10;
+        now.day.val   = 0x25;
+        now.autoset_weekday();
+        fired = 0;
+    }
+
+    // sets the local clock like a resync does, millisecond 0 of the second
+    void set_time(const uint8_t hour, const uint8_t minute, const uint8_t second, const bool uses_summertime) {
+        now.hour   = BCD::int_to_bcd(hour);
+        now.minute = BCD::int_to_bcd(minute);
+        now.second = second;
+        now.uses_summertime = uses_summertime;
+        now.timezone_change_scheduled = false;
+        now.leap_second_scheduled = false;
+        millisecond = 0;
+        ++time_sequence;
+    }
+
+    uint64_t instant(const uint8_t hour, const uint8_t minute, const uint8_t second, const bool uses_summertime) {
+        Clock::time_t time;
+        DCF77_Clock::convert_time(now, time);
+        time.hour   = BCD::int_to_bcd(hour);
+        time.minute = BCD::int_to_bcd(minute);
+        time.second = BCD::int_to_bcd(second);
+        time.uses_summertime = uses_summertime;
+        return Internal::DCF77_Scheduler::get_instant(time);
+    }
+
+    // one 1 kHz tick of the local clock, the time advances after millisecond 999
+    void tick(const Clock::clock_state_t clock_state = Clock::synced) {
+        scheduler.process_1_kHz_tick(clock_state, time_sequence, now, millisecond);
+        if (++millisecond == 1000) {
+            millisecond = 0;
+            now.advance_second();
+            ++time_sequence;
+        }
+    }
+
+    void run(const uint32_t ticks, const Clock::clock_state_t clock_state = Clock::synced) {
+        for (uint32_t i = 0; i < ticks; ++i) {
+            tick(clock_state);
+        }
+    }
+
+    bool fired_at(const uint8_t hour, const uint8_t minute, const uint8_t second, const bool uses_summertime,
+                  const uint16_t ms) {
+        return fired_time.hour.val == BCD::int_to_bcd(hour).val && fired_time.minute.val == BCD::int_to_bcd(minute).val &&
+               fired_time.second == second && fired_time.uses_summertime == uses_summertime && fired_millisecond == ms;
+    }
+}
+
+void test_Scheduler() {
+    using namespace Scheduler_Test;
+
+    {  // summer time ends, 02:59:59 CEST --> 02:00:00 CET
+        setup();
+        set_time(2, 59, 50, true);
+        now.timezone_change_scheduled = true;
+        scheduler.schedule(timer_a, instant(2, 59, 55, true), 999, record);
+        scheduler.schedule(timer_b, instant(2, 0, 0, false), 0, record);
+        assert(F("scheduled timers are armed"), DCF77_Clock::is_armed(timer_a) && DCF77_Clock::is_armed(timer_b));
+
+        run(5999);
+        assert(F("no timer before 02:59:55.999 CEST"), fired == 0, fired);
+        run(1);
+        assert(F("timer fires at 02:59:55.999 CEST"), fired == 1 && fired_at(2, 59, 55, true, 999),
+               fired, fired_millisecond);
+        assert(F("fired timer is not armed"), !DCF77_Clock::is_armed(timer_a));
+
+        run(4000);
+        assert(F("02:00:00 CET does not fire during 02:59 CEST"), fired == 1, fired);
+        assert(F("time switches to 02:00:00 CET"), now.hour.val == 0x02 && now.minute.val == 0x00 && !now.uses_summertime,
+               now.hour.val, now.minute.val, now.uses_summertime);
+        run(1);
+        assert(F("timer fires at 02:00:00.000 CET"), fired == 2 && fired_at(2, 0, 0, false, 0),
+               fired, fired_millisecond);
+    }
+
+    {  // leap second
+        setup();
+        now.day.val = 0x01;
+        now.month.val = 0x01;
+        set_time(0, 59, 59, false);
+        scheduler.schedule(timer_a, instant(0, 59, 60, false), 0, record);
+        scheduler.schedule(timer_b, instant(1, 0, 0, false), 0, record);
+
+        run(1000);
+        set_time(0, 59, 60, false);
+        run(1);
+        assert(F("timer fires in the leap second"), fired == 1 && fired_at(0, 59, 60, false, 0),
+               fired, fired_millisecond);
+        run(999);
+        set_time(1, 0, 0, false);
+        run(1);
+        assert(F("timer fires after the leap second"), fired == 2 && fired_at(1, 0, 0, false, 0),
+               fired, fired_millisecond);
+    }
+
+    {  // resync backward
+        setup();
+        set_time(12, 0, 20, false);
+        scheduler.schedule(timer_a, instant(12, 0, 20, false), 700, record);
+        run(300);
+        set_time(12, 0, 15, false);
+        run(5700);
+        assert(F("no timer while the time repeats after a backward resync"), fired == 0, fired);
+        run(1);
+        assert(F("timer fires once the time is reached again"), fired == 1 && fired_at(12, 0, 20, false, 700),
+               fired, fired_millisecond);
+        run(2000);
+        assert(F("timer fires only once"), fired == 1, fired);
+    }
+
+    {  // resync forward
+        setup();
+        set_time(12, 0, 10, false);
+        scheduler.schedule(timer_a, instant(12, 0, 30, false), 0, record);
+        scheduler.schedule(timer_b, instant(12, 1, 0, false), 500, record);
+        run(1000);
+        set_time(12, 0, 40, false);
+        run(1);
+        assert(F("skipped timer fires once it is passed"), fired == 1 && fired_at(12, 0, 40, false, 0),
+               fired, fired_millisecond);
+        run(20499);
+        assert(F("no timer before 12:01:00.500"), fired == 1, fired);
+        run(1);
+        assert(F("future timer fires on time after a forward resync"), fired == 2 && fired_at(12, 1, 0, false, 500),
+               fired, fired_millisecond);
+    }
+
+    {  // past due timers that are armed while the scheduler is not running
+        setup();
+        set_time(12, 0, 10, false);
+        scheduler.schedule(timer_a, instant(12, 0, 5, false), 0, record);
+        run(1);
+        assert(F("past due timer fires on the first tick"), fired == 1 && fired_at(12, 0, 10, false, 0),
+               fired, fired_millisecond);
+
+        run(999, Clock::dirty);
+        scheduler.schedule(timer_a, instant(12, 0, 10, false), 500, record);
+        run(1000, Clock::dirty);
+        assert(F("no timer while the clock is dirty"), fired == 1, fired);
+        run(1);
+        assert(F("past due timer fires once the clock is good enough"), fired == 2 && fired_at(12, 0, 12, false, 0),
+               fired, fired_millisecond);
+    }
+
+    {  // cancel and schedule from within an action
+        setup();
+        set_time(12, 0, 10, false);
+        scheduler.schedule(timer_a, instant(12, 0, 11, false), 0, record_and_cancel_both);
+        scheduler.schedule(timer_b, instant(12, 0, 11, false), 0, record_and_cancel_both);
+        run(2000);
+        assert(F("action cancels a timer that is due at the same tick"), fired == 1 && fired_at(12, 0, 11, false, 0),
+               fired, fired_millisecond);
+        assert(F("cancelled timers are not armed"), !DCF77_Clock::is_armed(timer_a) && !DCF77_Clock::is_armed(timer_b));
+
+        fired = 0;
+        scheduler.schedule(timer_a, instant(12, 0, 12, false), 250, record_and_reschedule_a);
+        run(3000);
+        assert(F("action schedules its own timer again"), fired == 3 && fired_at(12, 0, 14, false, 250),
+               fired, fired_millisecond);
+        scheduler.cancel(timer_a);
+        run(2000);
+        assert(F("cancel stops a timer that schedules itself"), fired == 3 && !DCF77_Clock::is_armed(timer_a), fired);
+    }
+
+    {  // the scheduler is idle without armed timers
+        setup();
+        set_time(12, 0, 10, false);
+        run(1000);
+        assert(F("scheduler without timers is not running"), !scheduler.running && scheduler.armed_timers == 0,
+               scheduler.armed_timers);
+
+        scheduler.schedule(timer_a, instant(12, 0, 13, false), 100, record);
+        scheduler.schedule(timer_b, instant(12, 0, 12, false), 0, record);
+        run(1);
+        assert(F("scheduler with armed timers is running"), scheduler.running && scheduler.armed_timers == 2,
+               scheduler.armed_timers);
+        scheduler.cancel(timer_b);
+        scheduler.cancel(timer_b);
+        run(1);
+        assert(F("cancel disarms a timer only once"), scheduler.running && scheduler.armed_timers == 1,
+               scheduler.armed_timers);
+        run(2099);
+        assert(F("idle scheduler restarts for a timer"), fired == 1 && fired_at(12, 0, 13, false, 100),
+               fired, fired_millisecond);
+        run(1);
+        assert(F("scheduler stops after the last timer fired"), !scheduler.running && scheduler.armed_timers == 0,
+               scheduler.armed_timers);
+    }
+}
+
 
 uint64_t mirror_bits(uint16_t bits, uint8_t len) {
     uint16_t result = 0;
@@ -3057,6 +3355,24 @@ void test_DCF77_Encoder() {
         assert(F("2099 12 01 --> Wintertime"), encoder.uses_summertime == false, encoder.uses_summertime);
     }
 
+    {  // autoset_control_bits without a date keeps the decoded control bits
+        DCF77_Encoder encoder;
+
+        encoder.year.val = 0xff;
+        encoder.month.val = 0xff;
+        encoder.day.val = 0xff;
+        encoder.weekday.val = 0xff;
+        encoder.hour.val = 0x12;
+        encoder.minute.val = 0x00;
+        encoder.second = 0;
+        encoder.uses_summertime = true;
+        encoder.timezone_change_scheduled = true;
+        encoder.leap_second_scheduled = false;
+        encoder.autoset_control_bits();
+        assert(F("undefined date --> summertime kept"), encoder.uses_summertime == true, encoder.uses_summertime);
+        assert(F("undefined date --> timezone change kept"), encoder.timezone_change_scheduled == true, encoder.timezone_change_scheduled);
+    }
+
     {  // autoset_timezone_change_scheduled_change_scheduled
        // Timezone will be CET  before last Sunday in March 2:00
        // Timezone will be CEST after last Sunday in March 2:00
@@ -5155,7 +5471,7 @@ struct modulator {
     }
 };
 
-template <boolean want_high_resolution>
+template <boolean want_high_resolution, boolean want_date = true, uint16_t low_resolution = 100>
 struct Configuration_T {
     static const boolean want_high_phase_lock_resolution = want_high_resolution;
     //const boolean want_high_phase_lock_resolution = false;
@@ -5172,10 +5488,15 @@ struct Configuration_T {
     static const boolean high_phase_lock_resolution = want_high_phase_lock_resolution &&
                                                       has_lots_of_memory;
 
-    enum ticks_per_second_t : uint16_t { centi_seconds = 100, milli_seconds = 1000 };
+    enum ticks_per_second_t : uint16_t { centi_seconds = 100, five_milli_seconds = 200, four_milli_seconds = 250,
+                                         two_milli_seconds = 500, milli_seconds = 1000 };
     // this is the actuall sample rate
     static const ticks_per_second_t phase_lock_resolution = high_phase_lock_resolution ? milli_seconds
-                                                                                       : centi_seconds;
+                                                                                       : (ticks_per_second_t)low_resolution;
+
+    static const boolean fine_phase_tracking = false;
+    static const boolean compact_phase_bins = false;
+    static const boolean decode_date = want_date;
 };
 
 
@@ -5202,6 +5523,7 @@ void test_Demodulator_internal() {
     const uint16_t bins_per_10ms  = Demodulator_t::bins_per_10ms;
     const uint16_t bins_per_50ms  = Demodulator_t::bins_per_50ms;
     const uint16_t bins_per_100ms = Demodulator_t::bins_per_100ms;
+    const uint16_t bins_per_200ms = Demodulator_t::bins_per_200ms;
     const uint16_t samples_per_second = 1000;
     const uint16_t samples_per_bin = samples_per_second / bin_count;
 
@@ -5281,7 +5603,10 @@ void test_Demodulator_internal() {
         for (uint16_t offset = 0; offset < bin_count && offset < bin_count; ++offset) {
             decoder.setup();
 
-            for (uint16_t bin = 0; bin < 40*bin_count; ++bin) {
+            // run until the bins saturate, otherwise the integral still grows
+            // from period to period and near the wrap around the peak of the
+            // previous period may lose against a flank of the current one
+            for (uint32_t bin = 0; bin < (uint32_t)(decoder.N + 2)*bin_count; ++bin) {
                 const uint8_t data = ((bin+offset) % bin_count) < bins_per_100ms;
                 decoder.phase_binning(data);
             }
@@ -5297,7 +5622,7 @@ void test_Demodulator_internal() {
         for (uint16_t offset = 0; offset < bin_count && offset < bin_count; ++offset) {
             decoder.setup();
 
-            for (uint16_t bin = 0; bin < 40*bin_count; ++bin) {
+            for (uint32_t bin = 0; bin < (uint32_t)(decoder.N + 2)*bin_count; ++bin) {
                 const uint8_t data = ((bin+offset) % bin_count) < 2*bins_per_100ms;
                 decoder.phase_binning(data);
             }
@@ -5313,17 +5638,18 @@ void test_Demodulator_internal() {
     }
 
     {  // decode_200ms
+        controller_t controller;
         Demodulator_t decoder;
         controller_t::last_tick = (DCF77::tick_t) 0xFF;
         decoder.decoded_data = 0;
         for (int16_t bins_to_go = decoder.bins_per_200ms+1, bins_gone = 0; bins_to_go > 0; --bins_to_go, ++bins_gone) {
-            decoder.decode_200ms(0, bins_to_go);
+            decoder.decode_200ms(controller, 0, bins_to_go);
         }
         assert(F("clock controller not triggered after decoding ++200 ms"),
                controller_t::last_tick == (DCF77::tick_t) 0xFF,
                controller_t::last_tick,
                hires);
-        decoder.decode_200ms(0, 0);
+        decoder.decode_200ms(controller, 0, 0);
         assert(F("clock controller triggered after decoding ++++200 ms"),
                controller_t::last_tick != (DCF77::tick_t) 0xFF,
                controller_t::last_tick,
@@ -5336,7 +5662,7 @@ void test_Demodulator_internal() {
         controller_t::last_tick = (DCF77::tick_t) 0xFF;
         decoder.decoded_data = 0;
         for (int16_t bins_to_go = decoder.bins_per_200ms+1, bins_gone = 0; bins_to_go >= 0; --bins_to_go, ++bins_gone) {
-            decoder.decode_200ms(bins_gone < bins_per_50ms, bins_to_go);
+            decoder.decode_200ms(controller, bins_gone < bins_per_50ms, bins_to_go);
         }
         assert(F("decode 50ms 1 as sync marc"),
                controller_t::last_tick == DCF77::sync_mark,
@@ -5346,7 +5672,7 @@ void test_Demodulator_internal() {
         controller_t::last_tick = (DCF77::tick_t) 0xFF;
         decoder.decoded_data = 0;
         for (int16_t bins_to_go = decoder.bins_per_200ms+1, bins_gone = 0; bins_to_go >= 0; --bins_to_go, ++bins_gone) {
-            decoder.decode_200ms(bins_gone <= bins_per_50ms, bins_to_go);
+            decoder.decode_200ms(controller, bins_gone <= bins_per_50ms, bins_to_go);
         }
         assert(F("decode ++50ms 1 as short tick"),
                controller_t::last_tick == DCF77::short_tick,
@@ -5356,7 +5682,7 @@ void test_Demodulator_internal() {
         controller_t::last_tick = (DCF77::tick_t) 0xFF;
         decoder.decoded_data = 0;
         for (int16_t bins_to_go = decoder.bins_per_200ms+1, bins_gone = 0; bins_to_go >= 0; --bins_to_go, ++bins_gone) {
-            decoder.decode_200ms(bins_gone <= 3*bins_per_50ms, bins_to_go);
+            decoder.decode_200ms(controller, bins_gone <= bins_per_100ms + bins_per_50ms, bins_to_go);
         }
         assert(F("decode ++150ms as short tick"),
                controller_t::last_tick == DCF77::short_tick,
@@ -5366,7 +5692,7 @@ void test_Demodulator_internal() {
         controller_t::last_tick = (DCF77::tick_t) 0xFF;
         decoder.decoded_data = 0;
         for (int16_t bins_to_go = decoder.bins_per_200ms+1, bins_gone = 0; bins_to_go >= 0; --bins_to_go, ++bins_gone) {
-            decoder.decode_200ms(bins_gone <= 3*bins_per_50ms+1, bins_to_go);
+            decoder.decode_200ms(controller, bins_gone <= bins_per_100ms + bins_per_50ms + 1, bins_to_go);
         }
         assert(F("decode ++++150ms as long tick"),
                controller_t::last_tick == DCF77::long_tick,
@@ -5376,7 +5702,7 @@ void test_Demodulator_internal() {
         controller_t::last_tick = (DCF77::tick_t) 0xFF;
         decoder.decoded_data = 0;
         for (int16_t bins_to_go = decoder.bins_per_200ms+1, bins_gone = 0; bins_to_go >= 0; --bins_to_go, ++bins_gone) {
-            decoder.decode_200ms(1, bins_to_go);
+            decoder.decode_200ms(controller, 1, bins_to_go);
         }
         assert(F("decode all 1 as long tick"),
                controller_t::last_tick == DCF77::long_tick,
@@ -5386,8 +5712,8 @@ void test_Demodulator_internal() {
         controller_t::last_tick = (DCF77::tick_t) 0xFF;
         decoder.decoded_data = 0;
         for (int16_t bins_to_go = decoder.bins_per_200ms+1, bins_gone = 0; bins_to_go >= 0; --bins_to_go, ++bins_gone) {
-            decoder.decode_200ms(bins_gone <= bins_per_100ms ||
-                                 bins_gone > bins_per_100ms + bins_per_50ms +1 ,
+            decoder.decode_200ms(controller, bins_gone <= bins_per_100ms ||
+                                 bins_gone > bins_per_200ms + 1 - bins_per_50ms,
                                  bins_to_go);
         }
         assert(F("decode ++100ms 1 followed by ++50ms 0 and 50ms 1 as short tick"),
@@ -5398,7 +5724,7 @@ void test_Demodulator_internal() {
         controller_t::last_tick = (DCF77::tick_t) 0xFF;
         decoder.decoded_data = 0;
         for (int16_t bins_to_go = decoder.bins_per_200ms+1, bins_gone = 0; bins_to_go >= 0; --bins_to_go, ++bins_gone) {
-            decoder.decode_200ms(bins_gone <= bins_per_100ms+1 ||
+            decoder.decode_200ms(controller, bins_gone <= bins_per_100ms+1 ||
                                  bins_gone > bins_per_100ms+1 + bins_per_50ms,
                                  bins_to_go);
         }
@@ -5410,8 +5736,8 @@ void test_Demodulator_internal() {
         controller_t::last_tick = (DCF77::tick_t) 0xFF;
         decoder.decoded_data = 0;
         for (int16_t bins_to_go = decoder.bins_per_200ms+1, bins_gone = 0; bins_to_go >= 0; --bins_to_go, ++bins_gone) {
-            decoder.decode_200ms(bins_gone > decoder.bins_per_50ms &&
-                                 bins_gone <= 3*decoder.bins_per_50ms,
+            decoder.decode_200ms(controller, bins_gone > bins_per_100ms - bins_per_50ms &&
+                                 bins_gone <= bins_per_100ms + bins_per_50ms,
                                  bins_to_go);
         }
         assert(F("decode ++50ms 0 followed by 100ms 1 as sync marc"),
@@ -5421,7 +5747,7 @@ void test_Demodulator_internal() {
 
                 controller_t::last_tick = (DCF77::tick_t) 0xFF;
         for (int16_t bins_to_go = decoder.bins_per_200ms+1, bins_gone = 0; bins_to_go >= 0; --bins_to_go, ++bins_gone) {
-            decoder.decode_200ms(bins_gone > decoder.bins_per_50ms-1 && bins_gone <= 3*decoder.bins_per_50ms, bins_to_go);
+            decoder.decode_200ms(controller, bins_gone >= bins_per_100ms - bins_per_50ms && bins_gone <= bins_per_100ms + bins_per_50ms, bins_to_go);
         }
         assert(F("decode 50ms 0 followed ++100ms 1 as short tick"),
                controller_t::last_tick == DCF77::short_tick,
@@ -5430,7 +5756,7 @@ void test_Demodulator_internal() {
     }
 
     {  // stage_with_averages
-        if (samples_per_bin > 1) {
+        if (samples_per_bin == 10) {
             typename Demodulator_t::stage_with_averages stage;
 
             stage.sample_count = 1;
@@ -5468,6 +5794,47 @@ void test_Demodulator_internal() {
             assert(F("cummulated data above threshhold"), stage.avg() == 1,
                    stage.avg(), stage.sum);
         }
+
+        if (samples_per_bin > 1 && samples_per_bin != 10) {
+            // 2, 4 or 5 samples per bin, the majority of the samples decides,
+            // for an even count the duplicated sample breaks the tie
+            typename Demodulator_t::stage_with_averages stage;
+            const uint8_t duplicated_sample = Demodulator_t::duplicated_sample;
+
+            stage.reset();
+            for (uint8_t sample = 0; sample < samples_per_bin; ++sample) {
+                assert(F("data not ready before all samples"), stage.data_ready() == false,
+                       stage.data_ready(), sample, samples_per_bin);
+                stage.reduce(sample <= samples_per_bin / 2);
+            }
+            assert(F("data ready after all samples"), stage.data_ready() == true,
+                   stage.data_ready(), samples_per_bin);
+            assert(F("majority of ones above threshhold"), stage.avg() == 1,
+                   stage.avg(), stage.sum, samples_per_bin);
+
+            stage.reset();
+            for (uint8_t sample = 0; sample < samples_per_bin; ++sample) {
+                stage.reduce(sample >= samples_per_bin / 2 + 1);
+            }
+            assert(F("majority of zeroes below threshhold"), stage.avg() == 0,
+                   stage.avg(), stage.sum, samples_per_bin);
+
+            if (samples_per_bin % 2 == 0) {
+                stage.reset();
+                for (uint8_t sample = 0; sample < samples_per_bin; ++sample) {
+                    stage.reduce(sample < samples_per_bin / 2);
+                }
+                assert(F("tie with duplicated one above threshhold"), stage.avg() == 1,
+                       stage.avg(), stage.sum, duplicated_sample);
+
+                stage.reset();
+                for (uint8_t sample = 0; sample < samples_per_bin; ++sample) {
+                    stage.reduce(sample >= samples_per_bin / 2);
+                }
+                assert(F("tie with duplicated zero below threshhold"), stage.avg() == 0,
+                       stage.avg(), stage.sum, duplicated_sample);
+            }
+        }
     }
 
     {  // detector
@@ -5481,13 +5848,16 @@ todo();
 }
 
 void test_Demodulator() {
-    // Attention: depending on the resolution (100 or 1000 samples) the implemented
-    //            logic is different --> both must be tested
+    // Attention: depending on the resolution (100, 200, 250, 500 or 1000 bins) the
+    //            implemented logic is different --> all must be tested
 
     using namespace Internal;
 
     test_Demodulator_internal<Configuration_T<false> >();
     test_Demodulator_internal<Configuration_T<true> >();
+    test_Demodulator_internal<Configuration_T<false, true, 200> >();
+    test_Demodulator_internal<Configuration_T<false, true, 250> >();
+    test_Demodulator_internal<Configuration_T<false, true, 500> >();
 }
 
 void test_Binning() {
@@ -6826,6 +7196,111 @@ void test_Weekday_Decoder() {
     }
 }
 
+// true if the decoder does not change at all in the seconds it does not own
+template <typename Decoder>
+boolean ignores_foreign_seconds() {
+    Decoder decoder;
+    decoder.setup();
+    for (uint8_t pass = 0; pass < 3; ++pass) {
+        for (uint8_t second = 0; second < 60; ++second) {
+            uint8_t before[sizeof(Decoder)];
+            memcpy(before, &decoder, sizeof(Decoder));
+            decoder.process_tick(second, (second + pass) & 1);
+            if (!Decoder::owns_second(second) && memcmp(before, &decoder, sizeof(Decoder)) != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void test_Decoder_Pipeline() {
+    using namespace Internal;
+
+    assert(F("flag decoder ignores foreign seconds"),    ignores_foreign_seconds<DCF77_Flag_Decoder>());
+    assert(F("hour decoder ignores foreign seconds"),    ignores_foreign_seconds<DCF77_Hour_Decoder>());
+    assert(F("weekday decoder ignores foreign seconds"), ignores_foreign_seconds<DCF77_Weekday_Decoder>());
+    assert(F("day decoder ignores foreign seconds"),     ignores_foreign_seconds<DCF77_Day_Decoder>());
+    assert(F("month decoder ignores foreign seconds"),   ignores_foreign_seconds<DCF77_Month_Decoder>());
+    assert(F("year decoder ignores foreign seconds"),    ignores_foreign_seconds<DCF77_Year_Decoder>());
+
+    // flag, hour, weekday, day, month, year
+    typedef DCF77_Clock_Controller<Configuration_T<false>, DCF77_Frequency_Control>::Decoders Decoders;
+    assert(F("no decoder in second 0"),  Decoders::get_stages( 0) == 0, Decoders::get_stages( 0));
+    assert(F("flag in second 15"),       Decoders::get_stages(15) == 1, Decoders::get_stages(15));
+    assert(F("no decoder in second 20"), Decoders::get_stages(20) == 0, Decoders::get_stages(20));
+    assert(F("hour in second 29"),       Decoders::get_stages(29) == 2, Decoders::get_stages(29));
+    assert(F("hour, day in second 36"),  Decoders::get_stages(36) == (2|8), Decoders::get_stages(36));
+    assert(F("weekday, day in 42"),      Decoders::get_stages(42) == (4|8), Decoders::get_stages(42));
+    assert(F("weekday, month in 45"),    Decoders::get_stages(45) == (4|16), Decoders::get_stages(45));
+    assert(F("month, year in 51"),       Decoders::get_stages(51) == (16|32), Decoders::get_stages(51));
+    assert(F("flag, year in 58"),        Decoders::get_stages(58) == (1|32), Decoders::get_stages(58));
+    assert(F("no decoder in second 59"), Decoders::get_stages(59) == 0, Decoders::get_stages(59));
+
+    // without the date only the flag and the hour decoders remain
+    typedef DCF77_Clock_Controller<Configuration_T<false, false>, DCF77_Frequency_Control> Time_Only_Controller;
+    typedef Time_Only_Controller::Decoders Time_Only_Decoders;
+    assert(F("time only: hour in second 36"),  Time_Only_Decoders::get_stages(36) == 2, Time_Only_Decoders::get_stages(36));
+    assert(F("time only: nothing in 45"),      Time_Only_Decoders::get_stages(45) == 0, Time_Only_Decoders::get_stages(45));
+    assert(F("time only: flag in second 58"),  Time_Only_Decoders::get_stages(58) == 1, Time_Only_Decoders::get_stages(58));
+    assert(F("time only: smaller controller"),
+           sizeof(Time_Only_Controller) < sizeof(DCF77_Clock_Controller<Configuration_T<false>, DCF77_Frequency_Control>),
+           sizeof(Time_Only_Controller));
+
+    DCF77_Encoder now;
+    Time_Only_Controller::Year_Decoder_t Year_Decoder;
+    now.year.val = 0x17;
+    Year_Decoder.set_DCF77_Encoder(now);
+    assert(F("time only: undefined year"), now.year.val == 0xff, now.year.val);
+}
+
+template <uint16_t phase_tracking_resolution>
+void test_Frequency_Control_internal() {
+    using namespace Internal;
+    typedef DCF77_Frequency_Control_T<phase_tracking_resolution> Frequency_Control_t;
+
+    Frequency_Control_t frequency_control;
+    typename Frequency_Control_t::deviation_tracker_t &tracker = frequency_control.deviation_tracker;
+
+    // the local clock runs 20 ms per minute fast, that is 20 * resolution / 1000 ticks
+    const uint16_t ticks_fast_per_minute = 20;
+    const int16_t deviation_per_minute = ticks_fast_per_minute * phase_tracking_resolution / 1000;
+    const uint8_t start_minute = 57;
+    // three wraps of the 60000 ticks, e.g. 30 minutes for centi_seconds
+    const uint16_t minutes = 3 * 60000uL / (60uL * phase_tracking_resolution);
+
+    tracker.start(start_minute);
+    bool ok = true;
+    for (uint16_t minute = 1; ok && minute <= minutes; ++minute) {
+        if (minute % 2) {
+            for (uint16_t tick = 0; tick < 60000 + ticks_fast_per_minute; ++tick) {
+                frequency_control.process_1_kHz_tick();
+            }
+        } else {
+            frequency_control.process_1_kHz_ticks(30000);
+            frequency_control.process_1_kHz_ticks(30000 + ticks_fast_per_minute);
+        }
+
+        ok = tracker.elapsed_minutes == minute;
+        assert(F("one elapsed minute per minute"), ok,
+               phase_tracking_resolution, minute, tracker.elapsed_minutes);
+
+        const int16_t deviation = frequency_control.compute_phase_deviation(Frequency_Control_t::calibration_second,
+                                                                              (start_minute + minute) % 60);
+        ok = ok && deviation == minute * deviation_per_minute;
+        assert(F("deviation grows with the drift across the wraps"), deviation == minute * deviation_per_minute,
+               phase_tracking_resolution, minute, deviation);
+    }
+}
+
+void test_Frequency_Control() {
+    test_Frequency_Control_internal<100>();
+    test_Frequency_Control_internal<200>();
+    test_Frequency_Control_internal<250>();
+    test_Frequency_Control_internal<500>();
+    test_Frequency_Control_internal<1000>();
+}
+
 void boilerplate() {
     Serial.println();
     Serial.print(F("Test compiled: "));
@@ -6850,6 +7325,9 @@ void setup() {
     todo(); //test_DCF77_Clock()
     test_TMP();
     test_Arithmetic_Tools();
+    test_Sample_Queue();
+    test_Event_Queue();
+    test_Scheduler();
 
     test_DCF77_Encoder();
     todo(); //test_Convoluter() // todo, not urgent as implicitly tested with Demodulator
@@ -6865,9 +7343,10 @@ void setup() {
     test_Year_Decoder();
     test_Decade_Decoder();
     test_Weekday_Decoder();
+    test_Decoder_Pipeline();
 
     todo(); //test_Local_Clock()
-    todo(); //test_Frequency_Control()
+    test_Frequency_Control();
     todo(); //test_Clock_Controller()
     todo(); //test_Generic_1_kHz_Generator()
 
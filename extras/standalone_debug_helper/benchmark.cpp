@@ -0,0 +1,419 @@
+//
+//  www.blinkenlight.net
+//
+//  Copyright 2017 Udo Klein
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program. If not, see http://www.gnu.org/licenses/
+
+
+// Micro benchmarks for the hot paths of the library.
+//
+// Each benchmark calls one function of the library in a loop until at least
+// the minimum measurement time has passed. The input is a clean synthesized
+// signal, thus the decoders see the same data as in a simulation without
+// noise. The results are written as CSV
+//
+//   label,benchmark,resolution,iterations,ns_per_op,ops_per_s
+//
+// one line per benchmark. The label defaults to "-" and is intended to hold
+// the commit id if results of different commits are collected in one file.
+//
+// Keep in mind that the results are host results. They are not the timing on
+// the target. However if a change makes a hot path significantly slower on the
+// host it will most probably be slower on the target as well.
+
+#include "main.h"
+#include "../../dcf77.cpp"
+#include "configuration.h"
+#include <chrono>
+#include <cstring>
+#include <getopt.h>
+#include <memory>
+#include <vector>
+
+
+FakeSerial Serial;
+
+namespace Internal {
+    namespace Generic_1_kHz_Generator {
+        void setup() {
+            cumulated_phase_deviation = 0;
+        }
+
+        void setup(const Clock::input_provider_t input_provider) {
+            setup();
+        }
+    }
+}
+
+namespace Benchmark_Setup {
+    unsigned long min_time_ms = 200;
+    std::string label = "-";
+    std::vector<std::string> filters;
+}
+
+namespace Benchmark_Signal {
+    using namespace Internal;
+
+    const uint8_t seconds_per_minute = 60;
+
+    // one minute of clean signal starting at 17-01-01 00:00:00 CET
+    DCF77::tick_t ticks[seconds_per_minute];
+    uint8_t tick_values[seconds_per_minute];
+    std::vector<uint8_t> samples;
+
+    void setup_clock(DCF77_Encoder &now) {
+        now.reset();
+        now.year    = BCD::int_to_bcd(17);
+        now.month   = BCD::int_to_bcd(1);
+        now.day     = BCD::int_to_bcd(1);
+        now.weekday = BCD::int_to_bcd(7);
+        now.hour    = BCD::int_to_bcd(0);
+        now.minute  = BCD::int_to_bcd(0);
+        now.second  = 0;
+        now.autoset_control_bits();
+    }
+
+    void setup() {
+        DCF77_Encoder now;
+        setup_clock(now);
+
+        samples.clear();
+        for (uint8_t second = 0; second < seconds_per_minute; ++second) {
+            ticks[second] = now.get_current_signal();
+            // same mapping as the clock controller uses for the BCD decoders
+            tick_values[second] = (ticks[second] == DCF77::long_tick || ticks[second] == DCF77::undefined)? 1: 0;
+
+            const uint16_t high_ms = ticks[second] == DCF77::long_tick ? 200:
+                                     ticks[second] == DCF77::short_tick? 100: 0;
+            for (uint16_t ms = 0; ms < 1000; ++ms) {
+                samples.push_back(ms < high_ms);
+            }
+            now.advance_second();
+        }
+    }
+}
+
+namespace Benchmark {
+    typedef std::chrono::steady_clock clock;
+
+    // Forces the compiler to assume that value is read and modified. Thus
+    // the computation of value can not be optimized away.
+    template <typename T>
+    inline void escape(T &value) {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    bool is_selected(const std::string &name, const std::string &resolution) {
+        if (Benchmark_Setup::filters.empty()) { return true; }
+
+        const std::string full_name = name + "," + resolution;
+        for (const std::string &filter : Benchmark_Setup::filters) {
+            if (full_name.find(filter) != std::string::npos) { return true; }
+        }
+        return false;
+    }
+
+    void print_header() {
+        println(F("label,benchmark,resolution,iterations,ns_per_op,ops_per_s"));
+    }
+
+    // Calls operation() until the minimum measurement time has passed.
+    // The number of iterations is doubled until a run takes long enough,
+    // only the last run is reported.
+    template <typename Operation>
+    void measure(const char *name, const char *resolution, Operation operation) {
+        if (!is_selected(name, resolution)) { return; }
+
+        const double min_time_ns = 1e6 * Benchmark_Setup::min_time_ms;
+        uint64_t iterations = 1000;
+        double elapsed_ns;
+        for (;;) {
+            const clock::time_point start = clock::now();
+            for (uint64_t i = 0; i < iterations; ++i) {
+                operation();
+            }
+            elapsed_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+
+            if (elapsed_ns >= min_time_ns || iterations >= (1ULL << 40)) { break; }
+            iterations *= 2;
+        }
+
+        const double ns_per_op = elapsed_ns / iterations;
+        char line[256];
+        snprintf(line, sizeof(line), "%s,%s,%s,%llu,%.3f,%.0f",
+                 Benchmark_Setup::label.c_str(), name, resolution,
+                 (unsigned long long) iterations, ns_per_op, 1e9 / ns_per_op);
+        println(line);
+    }
+
+    template <typename Clock_Controller>
+    void measure_demodulator(const char *resolution) {
+        // the demodulator is a member of the clock controller, thus the type
+        // must be taken from the (complete) clock controller
+        typedef decltype(Clock_Controller::Demodulator) Demodulator;
+
+        // phase_binning() gets the averaged bins, at centi_seconds resolution
+        // this is every 10th sample of the clean signal
+        std::vector<uint8_t> bins;
+        for (size_t sample = 0; sample < Benchmark_Signal::samples.size(); sample += Demodulator::samples_per_bin) {
+            bins.push_back(Benchmark_Signal::samples[sample]);
+        }
+
+        {
+            Demodulator demodulator;
+            demodulator.setup();
+            size_t bin = 0;
+            measure("phase_binning", resolution, [&]() {
+                demodulator.phase_binning(bins[bin]);
+                bin = bin+1 < bins.size()? bin+1: 0;
+            });
+            escape(demodulator);
+        }
+
+        {
+            // the detector feeds the decoders once per second, thus it needs
+            // the complete controller
+            std::unique_ptr<Clock_Controller> clock_controller(new Clock_Controller());
+            clock_controller->setup();
+            const std::vector<uint8_t> &samples = Benchmark_Signal::samples;
+            size_t sample = 0;
+            measure("detector", resolution, [&]() {
+                clock_controller->Demodulator.detector(*clock_controller, samples[sample]);
+                sample = sample+1 < samples.size()? sample+1: 0;
+            });
+            escape(*clock_controller);
+        }
+    }
+
+    template <typename Clock_Controller>
+    void measure_quality_factor(const char *resolution) {
+        std::unique_ptr<Clock_Controller> clock_controller(new Clock_Controller());
+        clock_controller->setup();
+
+        // get all decoders into a locked state first
+        for (uint8_t minute = 0; minute < 5; ++minute) {
+            for (const uint8_t sample : Benchmark_Signal::samples) {
+                clock_controller->process_1_kHz_tick_data(sample);
+            }
+        }
+
+        volatile uint8_t quality_factor;
+        measure("get_overall_quality_factor", resolution, [&]() {
+            escape(*clock_controller);
+            quality_factor = clock_controller->get_overall_quality_factor();
+        });
+    }
+
+    // One operation is one second of clean signal, either sample by sample or
+    // as the two constant runs that make up the second. The signal follows the
+    // clock, thus the controller stays synced.
+    template <typename Clock_Controller>
+    void measure_second(const char *resolution) {
+        using namespace Internal;
+
+        std::unique_ptr<Clock_Controller> clock_controller(new Clock_Controller());
+        DCF77_Encoder now;
+
+        const auto high_ms = [&]() -> uint16_t {
+            const DCF77::tick_t tick = now.get_current_signal();
+            return tick == DCF77::long_tick ? 200:
+                   tick == DCF77::short_tick? 100: 0;
+        };
+
+        const auto sync = [&]() {
+            clock_controller->setup();
+            Benchmark_Signal::setup_clock(now);
+            for (uint16_t second = 0; second < 300; ++second) {
+                clock_controller->process_1_kHz_tick_data_run(1, high_ms());
+                clock_controller->process_1_kHz_tick_data_run(0, 1000 - high_ms());
+                now.advance_second();
+            }
+        };
+
+        sync();
+        measure("second_per_sample", resolution, [&]() {
+            const uint16_t high = high_ms();
+            for (uint16_t ms = 0; ms < 1000; ++ms) {
+                clock_controller->process_1_kHz_tick_data(ms < high);
+            }
+            now.advance_second();
+        });
+        escape(*clock_controller);
+
+        sync();
+        measure("second_as_runs", resolution, [&]() {
+            const uint16_t high = high_ms();
+            clock_controller->process_1_kHz_tick_data_run(1, high);
+            clock_controller->process_1_kHz_tick_data_run(0, 1000 - high);
+            now.advance_second();
+        });
+        escape(*clock_controller);
+    }
+
+    template <typename Decoder, typename BCD_binning_t>
+    void measure_BCD_binning(const char *name) {
+        Decoder decoder;
+        decoder.setup();
+        uint8_t second = 0;
+        measure(name, "-", [&]() {
+            decoder.template BCD_binning<BCD_binning_t>(second, Benchmark_Signal::tick_values[second]);
+            second = second < Benchmark_Signal::seconds_per_minute-1? second+1: 0;
+        });
+        escape(decoder);
+
+        // only the seconds where the decoder actually works, the last one publishes the maximum
+        const uint8_t first_second = BCD_binning_t::signal_bitno_offset;
+        const uint8_t last_second = first_second + BCD_binning_t::significant_bits + BCD_binning_t::with_parity;
+        decoder.setup();
+        second = first_second;
+        measure((std::string(name) + "_active").c_str(), "-", [&]() {
+            decoder.template BCD_binning<BCD_binning_t>(second, Benchmark_Signal::tick_values[second]);
+            second = second < last_second? second+1: first_second;
+        });
+        escape(decoder);
+    }
+
+    void measure_decoders() {
+        using namespace Internal;
+
+        measure_BCD_binning<DCF77_Minute_Decoder,  DCF77_Minute_template_parameters::BCD_binning_t> ("BCD_binning_minute");
+        measure_BCD_binning<DCF77_Hour_Decoder,    DCF77_Hour_template_parameters::BCD_binning_t>   ("BCD_binning_hour");
+        measure_BCD_binning<DCF77_Weekday_Decoder, DCF77_Weekday_template_parameters::BCD_binning_t>("BCD_binning_weekday");
+        measure_BCD_binning<DCF77_Day_Decoder,     DCF77_Day_template_parameters::BCD_binning_t>    ("BCD_binning_day");
+        measure_BCD_binning<DCF77_Month_Decoder,   DCF77_Month_template_parameters::BCD_binning_t>  ("BCD_binning_month");
+        measure_BCD_binning<DCF77_Year_Decoder,    DCF77_Year_template_parameters::BCD_binning_t>   ("BCD_binning_year");
+        measure_BCD_binning<DCF77_Decade_Decoder,  DCF77_Decade_template_parameters::BCD_binning_t> ("BCD_binning_decade");
+
+        {
+            DCF77_Second_Decoder decoder;
+            decoder.setup();
+            uint8_t second = 0;
+            measure("sync_mark_binning", "-", [&]() {
+                decoder.sync_mark_binning(Benchmark_Signal::ticks[second]);
+                second = second < Benchmark_Signal::seconds_per_minute-1? second+1: 0;
+            });
+            escape(decoder);
+        }
+        {
+            DCF77_Second_Decoder decoder;
+            decoder.setup();
+            DCF77_Encoder now;
+            Benchmark_Signal::setup_clock(now);
+            // the kernel is set up once, the signal repeats the same minute anyway
+            decoder.set_convolution_time(now);
+            uint8_t second = 0;
+            measure("convolution_binning", "-", [&]() {
+                decoder.convolution_binning(Benchmark_Signal::ticks[second]);
+                second = second < Benchmark_Signal::seconds_per_minute-1? second+1: 0;
+            });
+            escape(decoder);
+        }
+    }
+
+    void measure_encoder() {
+        using namespace Internal;
+
+        DCF77_Encoder now;
+
+        Benchmark_Signal::setup_clock(now);
+        measure("advance_second", "-", [&]() {
+            now.advance_second();
+            escape(now);
+        });
+
+        Benchmark_Signal::setup_clock(now);
+        measure("advance_minute", "-", [&]() {
+            now.advance_minute();
+            escape(now);
+        });
+
+        Benchmark_Signal::setup_clock(now);
+        volatile DCF77::tick_t tick;
+        measure("get_current_signal", "-", [&]() {
+            now.second = now.second < Benchmark_Signal::seconds_per_minute-1? now.second+1: 0;
+            escape(now);
+            tick = now.get_current_signal();
+        });
+
+        Benchmark_Signal::setup_clock(now);
+        DCF77::serialized_clock_stream stream;
+        measure("get_serialized_clock_stream", "-", [&]() {
+            escape(now);
+            now.get_serialized_clock_stream(stream);
+            escape(stream);
+        });
+    }
+}
+
+void help() {
+    println(F("benchmark [-t min_time_ms] [-l label] [filter ...]"));
+    println();
+    println(F("Runs the micro benchmarks and writes the results as CSV to stdout"));
+    println(F("    label,benchmark,resolution,iterations,ns_per_op,ops_per_s"));
+    println();
+    println(F("-h, --help          print this help"));
+    println(F("-t, --min_time      minimum measurement time per benchmark in ms, default 200"));
+    println(F("-l, --label         value of the label column, e.g. the commit id, default -"));
+    println(F("filter              run only benchmarks where \"benchmark,resolution\" contains"));
+    println(F("                    one of the filters, e.g. \"detector\" or \"milli_seconds\""));
+}
+
+int main(int argc, char * argv[]) {
+    static struct option long_options[] = {
+        {"help",     no_argument,       0, 'h'},
+        {"min_time", required_argument, 0, 't'},
+        {"label",    required_argument, 0, 'l'},
+        {0, 0, 0, 0}
+    };
+
+    int option;
+    while ((option = getopt_long(argc, argv, "ht:l:", long_options, NULL)) != -1) {
+        switch (option) {
+            case 'h':
+                help();
+                return 0;
+            case 't':
+                Benchmark_Setup::min_time_ms = strtoul(optarg, NULL, 10);
+                break;
+            case 'l':
+                Benchmark_Setup::label = optarg;
+                break;
+            default:
+                help();
+                return 1;
+        }
+    }
+    for (int index = optind; index < argc; ++index) {
+        Benchmark_Setup::filters.push_back(argv[index]);
+    }
+
+    using namespace Internal;
+    typedef DCF77_Clock_Controller<Configuration_lores_T, DCF77_Frequency_Control_T<Configuration_lores_T::phase_tracking_resolution> > Clock_Controller_lores;
+    typedef DCF77_Clock_Controller<Configuration_hires_T, DCF77_Frequency_Control_T<Configuration_hires_T::phase_tracking_resolution> > Clock_Controller_hires;
+
+    Benchmark_Signal::setup();
+
+    Benchmark::print_header();
+    Benchmark::measure_demodulator<Clock_Controller_lores>("centi_seconds");
+    Benchmark::measure_demodulator<Clock_Controller_hires>("milli_seconds");
+    Benchmark::measure_decoders();
+    Benchmark::measure_encoder();
+    Benchmark::measure_quality_factor<Clock_Controller_lores>("centi_seconds");
+    Benchmark::measure_quality_factor<Clock_Controller_hires>("milli_seconds");
+    Benchmark::measure_second<Clock_Controller_lores>("centi_seconds");
+    Benchmark::measure_second<Clock_Controller_hires>("milli_seconds");
+
+    return 0;
+}
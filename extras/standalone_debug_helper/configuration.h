@@ -0,0 +1,108 @@
+//
+//  www.blinkenlight.net
+//
+//  Copyright 2017 Udo Klein
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program. If not, see http://www.gnu.org/licenses/
+
+#ifndef DCF77_CONFIGURATION_H
+#define DCF77_CONFIGURATION_H
+
+// The library configurations used by the debug helper and the benchmark.
+// They differ only by the phase lock resolution.
+
+// Build with -DAMORTIZE_1_HZ_WORK=1 to spread the 1 Hz work of the clock
+// controller over several 1 kHz ticks, see Configuration::amortize_1_Hz_work.
+#if !defined(AMORTIZE_1_HZ_WORK)
+    #define AMORTIZE_1_HZ_WORK 0
+#endif
+
+// Build with -DFINE_PHASE_TRACKING=1 to track the phase with 1 ms resolution
+// in the centi_seconds configuration, see Configuration::want_fine_phase_tracking.
+#if !defined(FINE_PHASE_TRACKING)
+    #define FINE_PHASE_TRACKING 0
+#endif
+
+// Build with -DCOMPACT_PHASE_BINS=1 to store the phase bins of the milli_seconds
+// configuration with 8 bits, see Configuration::want_compact_phase_bins.
+#if !defined(COMPACT_PHASE_BINS)
+    #define COMPACT_PHASE_BINS 0
+#endif
+
+// Build with -DDECODE_DATE=0 for a time of day only clock without the date
+// decoders, see Configuration::decode_date.
+#if !defined(DECODE_DATE)
+    #define DECODE_DATE 1
+#endif
+
+// Build with e.g. -DLOW_PHASE_LOCK_RESOLUTION=five_milli_seconds to replay with
+// one of the intermediate resolutions instead of centi_seconds.
+#if !defined(LOW_PHASE_LOCK_RESOLUTION)
+    #define LOW_PHASE_LOCK_RESOLUTION centi_seconds
+#endif
+
+struct Configuration_lores_T {
+    enum ticks_per_second_t : uint16_t { centi_seconds = 100, five_milli_seconds = 200, four_milli_seconds = 250,
+                                         two_milli_seconds = 500, milli_seconds = 1000 };
+    // this is the actuall sample rate
+    static const ticks_per_second_t phase_lock_resolution = LOW_PHASE_LOCK_RESOLUTION;
+    static const bool fine_phase_tracking = FINE_PHASE_TRACKING;
+    // the resolution of the phase that drives the local clock and the frequency control
+    static const ticks_per_second_t phase_tracking_resolution = fine_phase_tracking ? milli_seconds
+                                                                                    : phase_lock_resolution;
+    // 8 bit bins are only an option for the 1000 bins
+    static const bool compact_phase_bins = false;
+
+    enum quality_factor_sync_threshold_t : uint8_t { aggressive_sync = 1, standard_sync = 2, conservative_sync = 3 };
+    static const uint8_t quality_factor_sync_threshold = quality_factor_sync_threshold_t::aggressive_sync;
+
+    enum demodulator_quality_threshold_t : uint8_t { standard_quality = 10 };
+    static const uint8_t unacceptable_demodulator_quality = demodulator_quality_threshold_t::standard_quality;
+
+    enum controller_minute_quality_threshold_t : uint8_t { aggressive_minute_quality = 0, standard_minute_quality = 2, conservative_minute_quality = 4, paranoid_minute_quality = 6 };
+    static const uint8_t unacceptable_minute_decoder_quality = controller_minute_quality_threshold_t::aggressive_minute_quality;
+
+    static const bool has_stable_ambient_temperature = true;
+
+    static const bool amortize_1_Hz_work = AMORTIZE_1_HZ_WORK;
+
+    static const bool decode_date = DECODE_DATE;
+};
+
+struct Configuration_hires_T {
+    enum ticks_per_second_t : uint16_t { centi_seconds = 100, milli_seconds = 1000 };
+    // this is the actuall sample rate
+    static const ticks_per_second_t phase_lock_resolution = milli_seconds;
+    // the phase lock resolution is already 1 ms
+    static const bool fine_phase_tracking = false;
+    static const ticks_per_second_t phase_tracking_resolution = milli_seconds;
+    static const bool compact_phase_bins = COMPACT_PHASE_BINS;
+
+    enum quality_factor_sync_threshold_t : uint8_t { aggressive_sync = 1, standard_sync = 2, conservative_sync = 3 };
+    static const uint8_t quality_factor_sync_threshold = quality_factor_sync_threshold_t::aggressive_sync;
+
+    enum demodulator_quality_threshold_t : uint8_t { standard_quality = 10 };
+    static const uint8_t unacceptable_demodulator_quality = demodulator_quality_threshold_t::standard_quality;
+
+    enum controller_minute_quality_threshold_t : uint8_t { aggressive_minute_quality = 0, standard_minute_quality = 2, conservative_minute_quality = 4, paranoid_minute_quality = 6 };
+    static const uint8_t unacceptable_minute_decoder_quality = controller_minute_quality_threshold_t::aggressive_minute_quality;
+
+    static const bool has_stable_ambient_temperature = true;
+
+    static const bool amortize_1_Hz_work = AMORTIZE_1_HZ_WORK;
+
+    static const bool decode_date = DECODE_DATE;
+};
+
+#endif // DCF77_CONFIGURATION_H
@@ -19,19 +19,38 @@
 
 #include "main.h"
 #include "../../dcf77.cpp"
+#include "configuration.h"
+#include <cstring>
 #include <fstream>
 #include <random>
 #include <getopt.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <memory>
+#include <thread>
+#include <vector>
 
 
 namespace Test_Setup {
     enum signal_source_t : uint8_t { filesystem = 1, synthesizer = 2 };
     signal_source_t signal_source = synthesizer;
 
-    enum file_format_t : uint8_t { swiss_army_debug_helper_scope = 1, dcf77_logs_de = 2 };
+    enum file_format_t : uint8_t { swiss_army_debug_helper_scope = 1, dcf77_logs_de = 2, bit_packed_capture = 3 };
     file_format_t file_format = dcf77_logs_de;
     std::string file_name = "";
 
+    // if set the unshaped input signal will be recorded in raw capture format
+    std::string capture_file_name = "";
+
+    enum scope_format_t : uint8_t { scope_text = 0, scope_csv = 1, scope_binary = 2 };
+    scope_format_t scope_format = scope_text;
+
     enum verbosity_level_t : uint8_t { quiet = 0, event_triggered = 1, always = 2 };
 
     struct verbosity_t {
@@ -39,6 +58,7 @@ namespace Test_Setup {
         verbosity_level_t show_debug_scope = quiet;
         verbosity_level_t show_debug_info  = quiet;
         verbosity_level_t show_synthesizer = quiet;
+        verbosity_level_t show_time_stream = quiet;
         //verbosity_level_t show_parser      = quiet;
     } verbosity;
 
@@ -79,50 +99,44 @@ namespace Test_Setup {
     boolean high_phase_lock_resolution = false;
 }
 
-struct Configuration_lores_T {
-    enum ticks_per_second_t : uint16_t { centi_seconds = 100, milli_seconds = 1000 };
-    // this is the actuall sample rate
-    static const ticks_per_second_t phase_lock_resolution = centi_seconds;
-
-    enum quality_factor_sync_threshold_t : uint8_t { aggressive_sync = 1, standard_sync = 2, conservative_sync = 3 };
-    static const uint8_t quality_factor_sync_threshold = quality_factor_sync_threshold_t::aggressive_sync;
-
-    enum demodulator_quality_threshold_t : uint8_t { standard_quality = 10 };
-    static const uint8_t unacceptable_demodulator_quality = demodulator_quality_threshold_t::standard_quality;
-
-    enum controller_minute_quality_threshold_t : uint8_t { aggressive_minute_quality = 0, standard_minute_quality = 2, conservative_minute_quality = 4, paranoid_minute_quality = 6 };
-    static const uint8_t unacceptable_minute_decoder_quality = controller_minute_quality_threshold_t::aggressive_minute_quality;
-};
-
-struct Configuration_hires_T {
-    enum ticks_per_second_t : uint16_t { centi_seconds = 100, milli_seconds = 1000 };
-    // this is the actuall sample rate
-    static const ticks_per_second_t phase_lock_resolution = milli_seconds;
-
-    enum quality_factor_sync_threshold_t : uint8_t { aggressive_sync = 1, standard_sync = 2, conservative_sync = 3 };
-    static const uint8_t quality_factor_sync_threshold = quality_factor_sync_threshold_t::aggressive_sync;
-
-    enum demodulator_quality_threshold_t : uint8_t { standard_quality = 10 };
-    static const uint8_t unacceptable_demodulator_quality = demodulator_quality_threshold_t::standard_quality;
-
-    enum controller_minute_quality_threshold_t : uint8_t { aggressive_minute_quality = 0, standard_minute_quality = 2, conservative_minute_quality = 4, paranoid_minute_quality = 6 };
-    static const uint8_t unacceptable_minute_decoder_quality = controller_minute_quality_threshold_t::aggressive_minute_quality;
-};
-
 FakeSerial Serial;
 
 namespace Statistics {
-    unsigned long clock_state_count[6] = {};
-    unsigned long clock_transition_count[6][6] = {};
-    // actually qf should always be <= 50, 100 was put in place to be absolutely sure to never overflow
-    unsigned long quality_factor_count[256] = {};
-    unsigned long prediction_match_count[256] = {};
+    struct counters_t {
+        unsigned long clock_state_count[6] = {};
+        unsigned long clock_transition_count[6][6] = {};
+        // actually qf should always be <= 50, 100 was put in place to be absolutely sure to never overflow
+        unsigned long quality_factor_count[256] = {};
+        unsigned long prediction_match_count[256] = {};
+
+        // called once per second of processed signal
+        void sample(const Clock::clock_state_t prev_state, const Clock::clock_state_t clock_state,
+                    const uint8_t quality_factor, const uint8_t prediction_match) {
+            clock_state_count[clock_state] += 1;
+            clock_transition_count[prev_state][clock_state] += 1;
+            quality_factor_count[quality_factor] += 1;
+            prediction_match_count[prediction_match] += 1;
+        }
+    };
+
+    // the counters of the single scenario run
+    counters_t counters;
 
     long double square(long double x) { return x*x; }
 
+    long double average(const unsigned long data[256]) {
+        unsigned long samples = 0;
+        long double avg = 0;
+        for (uint16_t n = 0; n < 256; ++n) {
+            samples += data[n];
+            avg += data[n] * n;
+        }
+        return samples > 0? avg / samples: 0;
+    }
+
     void indent() { print("  "); }
 
-    void dump_histogram(unsigned long data[256]) {
+    void dump_histogram(const unsigned long data[256]) {
         uint8_t max_n=1;
         uint8_t min_n=254;
 
@@ -165,7 +179,7 @@ namespace Statistics {
         println(std_deviation);
     }
 
-    void dump() {
+    void dump(const counters_t &counters = Statistics::counters) {
         const std::string clock_state[] = {"useless ", "dirty   ", "free    ", "unlocked", "locked  ", "synced  "};
 
         println("\nClock State Statistics");
@@ -175,34 +189,174 @@ namespace Statistics {
             print(' ');
             print(clock_state[i]);
             print(": ");
-            println(clock_state_count[i]);
+            println(counters.clock_state_count[i]);
         }
         println("\nClock State Transition Statistics");
         for (uint8_t from = 0; from < 6; ++from) {
             for (uint8_t to = 0; to < 6; ++to) {
-                if (clock_transition_count[from][to]) {
+                if (counters.clock_transition_count[from][to]) {
                     indent();
                     print(clock_state[from]);
                     print(" => ");
                     print(clock_state[to]);
                     print(": ");
-                    println(clock_transition_count[from][to]);
+                    println(counters.clock_transition_count[from][to]);
                 }
             }
         }
 
         println("\nQuality Factor Statistics");
-        dump_histogram(quality_factor_count);
+        dump_histogram(counters.quality_factor_count);
 
         println("\nPrediction Match Statistics");
-        dump_histogram(prediction_match_count);
+        dump_histogram(counters.prediction_match_count);
+    }
+}
+
+namespace Tick_Profiler {
+    // If enabled each call of the clock controller's process_1_kHz_tick_data is
+    // timed. Blocks and runs are processed sample by sample then. Each tick is
+    // counted for "all", for each path that ran during it or for "none" if no
+    // path ran at all. The host is way faster than the targets. Still the ratio
+    // between the worst case ticks and the average tick is roughly the same.
+    bool enabled = false;
+
+    typedef std::chrono::steady_clock clock;
+
+    // Log linear buckets: one bucket per ns below 64 ns, above 32 buckets per
+    // power of two. Thus no bucket is wider than about 3% of its lower bound.
+    const uint16_t linear_buckets = 64;
+    const uint8_t  sub_bucket_bits = 5;
+    const uint8_t  max_exponent = 40;  // about 18 minutes, for sure more than any tick
+    const uint16_t bucket_count = linear_buckets + (max_exponent - 6) * (1 << sub_bucket_bits);
+
+    uint16_t bucket(uint64_t ns) {
+        if (ns < linear_buckets) { return ns; }
+        if (ns >> max_exponent) { ns = (1ULL << max_exponent) - 1; }
+
+        const uint8_t exponent = 63 - __builtin_clzll(ns);
+        return linear_buckets + (exponent - 6) * (1 << sub_bucket_bits)
+                              + ((ns >> (exponent - sub_bucket_bits)) & ((1 << sub_bucket_bits) - 1));
+    }
+
+    uint64_t lower_bound(const uint16_t bucket) {
+        if (bucket < linear_buckets) { return bucket; }
+
+        const uint8_t exponent = 6 + (bucket - linear_buckets) / (1 << sub_bucket_bits);
+        const uint64_t sub_bucket = (bucket - linear_buckets) % (1 << sub_bucket_bits);
+        return ((1 << sub_bucket_bits) + sub_bucket) << (exponent - sub_bucket_bits);
+    }
+
+    uint64_t upper_bound(const uint16_t bucket) {
+        return lower_bound(bucket + 1) - 1;
+    }
+
+    // tags 0..path_count-1 are the paths
+    const uint8_t tag_none = path_count;
+    const uint8_t tag_all  = path_count + 1;
+    const uint8_t tag_count = path_count + 2;
+    const char * const tag_name[tag_count] = {
+        "decode", "flush", "local_clock_flush", "compute_max_index",
+        "convolution_time", "phase_lost", "sync_lost", "work_slice", "none", "all" };
+
+    struct histogram_t {
+        uint64_t ticks = 0;
+        uint64_t total_ns = 0;
+        uint64_t max_ns = 0;
+        uint64_t max_tick = 0;
+        uint64_t over_1_ms = 0;
+        uint64_t count[bucket_count] = {};
+
+        void record(const uint64_t ns, const uint64_t tick) {
+            ++ticks;
+            total_ns += ns;
+            if (ns > max_ns) {
+                max_ns = ns;
+                max_tick = tick;
+            }
+            over_1_ms += ns > 1000000;
+            ++count[bucket(ns)];
+        }
+
+        // nearest rank percentile, the upper bound of the bucket but not above the max
+        uint64_t percentile(const double per_cent) const {
+            const uint64_t rank = max((uint64_t)1, (uint64_t)ceil(per_cent / 100 * ticks));
+            uint64_t cumulated = 0;
+            for (uint16_t index = 0; index < bucket_count; ++index) {
+                cumulated += count[index];
+                if (cumulated >= rank) { return min(upper_bound(index), max_ns); }
+            }
+            return max_ns;
+        }
+    };
+
+    histogram_t histograms[tag_count];
+    uint64_t tick_count = 0;
+    clock::time_point tick_start;
+
+    void start_tick() {
+        current_paths = 0;
+        tick_start = clock::now();
+    }
+
+    void end_tick() {
+        const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - tick_start).count();
+
+        histograms[tag_all].record(ns, tick_count);
+        if (current_paths == 0) {
+            histograms[tag_none].record(ns, tick_count);
+        }
+        for (uint8_t path = 0; path < path_count; ++path) {
+            if (current_paths & (1 << path)) {
+                histograms[path].record(ns, tick_count);
+            }
+        }
+        ++tick_count;
+    }
+
+    void dump() {
+        // max_tick is the number of the tick since the start, i.e. the millisecond
+        println("\nTick Latency Statistics");
+        println("path,ticks,mean_ns,p50_ns,p99_ns,p99.99_ns,max_ns,max_tick,over_1_ms");
+        for (uint8_t tag = 0; tag < tag_count; ++tag) {
+            const histogram_t &histogram = histograms[tag];
+            if (histogram.ticks == 0) { continue; }
+
+            char line[256];
+            snprintf(line, sizeof(line), "%s,%llu,%.1f,%llu,%llu,%llu,%llu,%llu,%llu",
+                     tag_name[tag],
+                     (unsigned long long) histogram.ticks,
+                     (double) histogram.total_ns / histogram.ticks,
+                     (unsigned long long) histogram.percentile(50),
+                     (unsigned long long) histogram.percentile(99),
+                     (unsigned long long) histogram.percentile(99.99),
+                     (unsigned long long) histogram.max_ns,
+                     (unsigned long long) histogram.max_tick,
+                     (unsigned long long) histogram.over_1_ms);
+            println(line);
+        }
+
+        println("\nTick Latency Histogram");
+        println("path,lower_ns,upper_ns,ticks");
+        for (uint8_t tag = 0; tag < tag_count; ++tag) {
+            for (uint16_t index = 0; index < bucket_count; ++index) {
+                if (histograms[tag].count[index] == 0) { continue; }
+
+                char line[256];
+                snprintf(line, sizeof(line), "%s,%llu,%llu,%llu",
+                         tag_name[tag],
+                         (unsigned long long) lower_bound(index),
+                         (unsigned long long) upper_bound(index),
+                         (unsigned long long) histograms[tag].count[index]);
+                println(line);
+            }
+        }
     }
 }
 
 namespace Internal {
     namespace Generic_1_kHz_Generator {
         void setup() {
-            adjust_pp16m = 0;
             cumulated_phase_deviation = 0;
         }
 
@@ -214,49 +368,104 @@ namespace Internal {
 
 namespace Debug_Clock {
     using namespace Internal;
-    typedef DCF77_Clock_Controller<Configuration_lores_T, DCF77_Frequency_Control> Clock_Controller_lores;
-    typedef DCF77_Clock_Controller<Configuration_hires_T, DCF77_Frequency_Control> Clock_Controller_hires;
+    typedef DCF77_Clock_Controller<Configuration_lores_T, DCF77_Frequency_Control_T<Configuration_lores_T::phase_tracking_resolution> > Clock_Controller_lores;
+    typedef DCF77_Clock_Controller<Configuration_hires_T, DCF77_Frequency_Control_T<Configuration_hires_T::phase_tracking_resolution> > Clock_Controller_hires;
+
+    Clock_Controller_lores clock_controller_lores;
+    Clock_Controller_hires clock_controller_hires;
 
     void setup() {
         if (Test_Setup::high_phase_lock_resolution) {
-            Clock_Controller_hires::setup();
+            clock_controller_hires.setup();
         } else {
-            Clock_Controller_lores::setup();
+            clock_controller_lores.setup();
         }
     }
 
     void setup(const Clock::input_provider_t input_provider, const Clock::output_handler_t output_handler) {
         if (Test_Setup::high_phase_lock_resolution) {
-            Clock_Controller_hires::setup();
-            Clock_Controller_hires::set_output_handler(output_handler);
+            clock_controller_hires.setup();
+            clock_controller_hires.set_output_handler(output_handler);
         } else {
-            Clock_Controller_lores::setup();
-            Clock_Controller_lores::set_output_handler(output_handler);
+            clock_controller_lores.setup();
+            clock_controller_lores.set_output_handler(output_handler);
         }
         Generic_1_kHz_Generator::setup();
     };
 
     void debug() {
         if (Test_Setup::high_phase_lock_resolution) {
-            Clock_Controller_hires::debug();
+            clock_controller_hires.debug();
         } else {
-            Clock_Controller_lores::debug();
+            clock_controller_lores.debug();
         }
     }
 
     void set_output_handler(const Clock::output_handler_t output_handler) {
         if (Test_Setup::high_phase_lock_resolution) {
-            Clock_Controller_hires::set_output_handler(output_handler);
+            clock_controller_hires.set_output_handler(output_handler);
         } else {
-            Clock_Controller_lores::set_output_handler(output_handler);
+            clock_controller_lores.set_output_handler(output_handler);
         }
     }
 
     void process_1_kHz_tick_data(const uint8_t the_data) {
+        if (Tick_Profiler::enabled) { Tick_Profiler::start_tick(); }
+
+        if (Test_Setup::high_phase_lock_resolution) {
+            clock_controller_hires.process_1_kHz_tick_data(the_data);
+        } else {
+            clock_controller_lores.process_1_kHz_tick_data(the_data);
+        }
+
+        if (Tick_Profiler::enabled) { Tick_Profiler::end_tick(); }
+    }
+
+    // The profiler must time each single tick. Just like the block and run API
+    // of the controller stop right after the sample that triggered a frequency
+    // adjustment.
+    template <typename Clock_Controller>
+    uint32_t process_1_kHz_tick_data_profiled(Clock_Controller &clock_controller,
+                                              const uint64_t *packed_samples, const uint32_t sample_count) {
+        clock_controller.frequency_adjusted = false;
+        uint32_t sample = 0;
+        while (sample < sample_count && !clock_controller.frequency_adjusted) {
+            process_1_kHz_tick_data(Clock_Controller::get_sample(packed_samples, sample));
+            ++sample;
+        }
+        return sample;
+    }
+
+    uint32_t process_1_kHz_tick_data(const uint64_t *packed_samples, const uint32_t sample_count) {
+        if (Tick_Profiler::enabled) {
+            if (Test_Setup::high_phase_lock_resolution) {
+                return process_1_kHz_tick_data_profiled(clock_controller_hires, packed_samples, sample_count);
+            } else {
+                return process_1_kHz_tick_data_profiled(clock_controller_lores, packed_samples, sample_count);
+            }
+        }
+
+        if (Test_Setup::high_phase_lock_resolution) {
+            return clock_controller_hires.process_1_kHz_tick_data(packed_samples, sample_count);
+        } else {
+            return clock_controller_lores.process_1_kHz_tick_data(packed_samples, sample_count);
+        }
+    }
+
+    uint32_t process_1_kHz_tick_data_run(const uint8_t the_data, const uint32_t sample_count) {
+        if (Tick_Profiler::enabled) {
+            const uint64_t run = the_data? ~0ULL: 0;
+            if (Test_Setup::high_phase_lock_resolution) {
+                return process_1_kHz_tick_data_profiled(clock_controller_hires, &run, min(sample_count, (uint32_t)64));
+            } else {
+                return process_1_kHz_tick_data_profiled(clock_controller_lores, &run, min(sample_count, (uint32_t)64));
+            }
+        }
+
         if (Test_Setup::high_phase_lock_resolution) {
-            Clock_Controller_hires::process_1_kHz_tick_data(the_data);
+            return clock_controller_hires.process_1_kHz_tick_data_run(the_data, sample_count);
         } else {
-            Clock_Controller_lores::process_1_kHz_tick_data(the_data);
+            return clock_controller_lores.process_1_kHz_tick_data_run(the_data, sample_count);
         }
     }
 
@@ -276,9 +485,9 @@ namespace Debug_Clock {
     void read_current_time(Clock::time_t &now) {
         DCF77_Encoder current_time;
         if (Test_Setup::high_phase_lock_resolution) {
-            Clock_Controller_hires::read_current_time(current_time);
+            clock_controller_hires.read_current_time(current_time);
         } else {
-            Clock_Controller_lores::read_current_time(current_time);
+            clock_controller_lores.read_current_time(current_time);
         }
         convert_time(current_time, now);
     };
@@ -286,9 +495,9 @@ namespace Debug_Clock {
     void read_future_time(Clock::time_t &now_plus_1s) {
         DCF77_Encoder current_time;
         if (Test_Setup::high_phase_lock_resolution) {
-            Clock_Controller_hires::read_current_time(current_time);
+            clock_controller_hires.read_current_time(current_time);
         } else {
-            Clock_Controller_lores::read_current_time(current_time);
+            clock_controller_lores.read_current_time(current_time);
         }
         current_time.advance_second();
 
@@ -322,25 +531,41 @@ namespace Debug_Clock {
 
     uint8_t get_overall_quality_factor() {
         if (Test_Setup::high_phase_lock_resolution) {
-            return Clock_Controller_hires::get_overall_quality_factor();
+            return clock_controller_hires.get_overall_quality_factor();
         } else {
-            return Clock_Controller_lores::get_overall_quality_factor();
+            return clock_controller_lores.get_overall_quality_factor();
         }
     };
 
     Clock::clock_state_t get_clock_state() {
         if (Test_Setup::high_phase_lock_resolution) {
-            return Clock_Controller_hires::get_clock_state();
+            return clock_controller_hires.get_clock_state();
         } else {
-            return Clock_Controller_lores::get_clock_state();
+            return clock_controller_lores.get_clock_state();
         }
     };
 
+    int16_t read_adjustment() {
+        if (Test_Setup::high_phase_lock_resolution) {
+            return clock_controller_hires.Frequency_Control.read_adjustment();
+        } else {
+            return clock_controller_lores.Frequency_Control.read_adjustment();
+        }
+    }
+
+    void debug_frequency_control() {
+        if (Test_Setup::high_phase_lock_resolution) {
+            clock_controller_hires.Frequency_Control.debug();
+        } else {
+            clock_controller_lores.Frequency_Control.debug();
+        }
+    }
+
     uint8_t get_prediction_match() {
         if (Test_Setup::high_phase_lock_resolution) {
-            return Clock_Controller_hires::get_prediction_match();
+            return clock_controller_hires.get_prediction_match();
         } else {
-            return Clock_Controller_lores::get_prediction_match();
+            return clock_controller_lores.get_prediction_match();
         }
     };
 }
@@ -383,69 +608,135 @@ namespace Scope {
             }
 
             if (Test_Setup::high_phase_lock_resolution) {
-                Debug_Clock::Clock_Controller_hires::Local_Clock.debug();
+                Debug_Clock::clock_controller_hires.Local_Clock.debug();
             } else {
-                Debug_Clock::Clock_Controller_lores::Local_Clock.debug();
+                Debug_Clock::clock_controller_lores.Local_Clock.debug();
             }
-            Internal::DCF77_Frequency_Control::debug();
+            Debug_Clock::debug_frequency_control();
         }
     }
 
-    void debug_10ms(int sum) {
-        static Clock::clock_state_t prev_state = Test_Setup::high_phase_lock_resolution ? Debug_Clock::Clock_Controller_hires::Local_Clock.get_state()
-                                                                                        : Debug_Clock::Clock_Controller_lores::Local_Clock.get_state() ;
-        static int16_t prev_adjustment = Internal::Generic_1_kHz_Generator::read_adjustment();
+    // One line per second with the decoded time and the clock state. This is
+    // the input of continuity_checker.py and of the regression test.
+    void time_stream_info() {
+        if (Test_Setup::verbosity.show_time_stream == Test_Setup::always) {
+            Clock::time_t now;
+            Debug_Clock::read_current_time(now);
 
-        static unsigned long line_count = 0;
+            Serial.print(F("Decoded time: "));
+            if (now.month.val > 0) {
+                Debug_Clock::print(now);
+            } else {
+                Serial.print(F("none"));
+            }
 
-        if (char_count == 0) { // begin of line
-            ++line_count;
-            if (Test_Setup::verbosity.show_debug_scope == Test_Setup::always) {
-                // ensure the line_count values will be aligned to the right
-                for (unsigned long val=line_count; val < 100000000; val *= 10) {
-                    print(' ');
-                }
-                print(line_count);
-                print(", ");
+            switch (Debug_Clock::get_clock_state()) {
+                case Clock::useless:  Serial.println(F(" useless"));  break;
+                case Clock::dirty:    Serial.println(F(" dirty"));    break;
+                case Clock::free:     Serial.println(F(" free"));     break;
+                case Clock::unlocked: Serial.println(F(" unlocked")); break;
+                case Clock::locked:   Serial.println(F(" locked"));   break;
+                case Clock::synced:   Serial.println(F(" synced"));   break;
+                default:              Serial.println(F(" undefined"));
             }
         }
+    }
 
-        // print one character
-        if (Test_Setup::verbosity.show_debug_scope == Test_Setup::always) {
-            if (sum == 0) {
-                print(char_count % 10 == 0 ? '+' : '-');
-            } else {
-                print(sum < 10? (char) ('0'+sum): 'X');
+    unsigned long line_count = 0;
+    uint8_t line_sums[characters_to_flush];
+
+    // Prints the first chars 10 ms sums of the current line. Collecting the sums
+    // and printing them in one go is way faster than printing each of them.
+    void print_line(const uint8_t chars, const Clock::clock_state_t clock_state) {
+        switch (Test_Setup::scope_format) {
+            case Test_Setup::scope_text: {
+                // line_count aligned to the right, followed by one character per sum
+                char line[32 + characters_to_flush];
+                uint16_t length = snprintf(line, 32, "%9lu, ", line_count);
+                for (uint8_t i = 0; i < chars; ++i) {
+                    const uint8_t sum = line_sums[i];
+                    line[length++] = sum == 0? (i % 10 == 0 ? '+' : '-'):
+                                     sum < 10? (char) ('0'+sum): 'X';
+                }
+                std::cout.write(line, length);
+                break;
             }
+            case Test_Setup::scope_csv: {
+                char line[32 + 3 * characters_to_flush];
+                uint16_t length = snprintf(line, 32, "%lu,%d", line_count, (int)clock_state);
+                for (uint8_t i = 0; i < chars; ++i) {
+                    line[length++] = ',';
+                    if (line_sums[i] >= 10) {
+                        line[length++] = '0' + line_sums[i] / 10;
+                    }
+                    line[length++] = '0' + line_sums[i] % 10;
+                }
+                std::cout.write(line, length);
+                break;
+            }
+            case Test_Setup::scope_binary: {
+                // only complete lines, see README.md for the record layout
+                if (chars == characters_to_flush) {
+                    const uint32_t record_line_count = line_count;
+                    const uint8_t record_clock_state = clock_state;
+                    std::cout.write((const char *)&record_line_count, sizeof(record_line_count));
+                    std::cout.write((const char *)&record_clock_state, sizeof(record_clock_state));
+                    std::cout.write((const char *)line_sums, characters_to_flush);
+                }
+                break;
+            }
+        }
+    }
+
+    // prints the incomplete last line, if any
+    void flush() {
+        if (char_count > 0 && Test_Setup::verbosity.show_debug_scope == Test_Setup::always) {
+            print_line(char_count, Debug_Clock::get_clock_state());
+        }
+    }
+
+    void debug_10ms(int sum) {
+        static Clock::clock_state_t prev_state = Test_Setup::high_phase_lock_resolution ? Debug_Clock::clock_controller_hires.Local_Clock.get_state()
+                                                                                        : Debug_Clock::clock_controller_lores.Local_Clock.get_state() ;
+        static int16_t prev_adjustment = Debug_Clock::read_adjustment();
+
+        if (char_count == 0) { // begin of line
+            ++line_count;
         }
+        line_sums[char_count] = sum;
 
         ++char_count;
         if (char_count == characters_to_flush) {
             char_count = 0;
-            const Clock::clock_state_t clock_state = Test_Setup::high_phase_lock_resolution ? Debug_Clock::Clock_Controller_hires::Local_Clock.get_state()
-                                                                                            : Debug_Clock::Clock_Controller_lores::Local_Clock.get_state();;
-            Statistics::clock_state_count[clock_state] += 1;
-            Statistics::clock_transition_count[prev_state][clock_state] += 1;
-            if (Test_Setup::high_phase_lock_resolution) {
-                Statistics::quality_factor_count[Debug_Clock::Clock_Controller_hires::get_overall_quality_factor()] += 1;
-                Statistics::prediction_match_count[Debug_Clock::Clock_Controller_hires::get_prediction_match()] += 1;
-            } else {
-                Statistics::quality_factor_count[Debug_Clock::Clock_Controller_lores::get_overall_quality_factor()] += 1;
-                Statistics::prediction_match_count[Debug_Clock::Clock_Controller_lores::get_prediction_match()] += 1;
+            const Clock::clock_state_t clock_state = Test_Setup::high_phase_lock_resolution ? Debug_Clock::clock_controller_hires.Local_Clock.get_state()
+                                                                                            : Debug_Clock::clock_controller_lores.Local_Clock.get_state();;
+            if (Test_Setup::verbosity.show_debug_scope == Test_Setup::always) {
+                print_line(characters_to_flush, clock_state);
             }
+            Statistics::counters.sample(prev_state, clock_state,
+                                        Debug_Clock::get_overall_quality_factor(),
+                                        Debug_Clock::get_prediction_match());
 
-            const int16_t adjustment = Internal::Generic_1_kHz_Generator::read_adjustment();
+            const int16_t adjustment = Debug_Clock::read_adjustment();
 
             second_tick_info(clock_state != prev_state || adjustment != prev_adjustment);
 
             prev_state = clock_state;
             prev_adjustment = adjustment;
 
-            if (Test_Setup::verbosity.show_debug_scope == Test_Setup::always) { println(); }
+            if (Test_Setup::verbosity.show_debug_scope == Test_Setup::always &&
+                Test_Setup::scope_format != Test_Setup::scope_binary) { println(); }
+            time_stream_info();
         }
     }
 
 
+    // Number of samples up to and including the next sample that completes a
+    // line. This is the next sample for which debug() will look at the clock.
+    uint32_t samples_to_next_line() {
+        return (characters_to_flush - 1 - char_count) * 10 + (10 - up_to_ten_ms);
+    }
+
     void debug(int signal) {
         static int sum = 0;
 
@@ -457,119 +748,386 @@ namespace Scope {
             up_to_ten_ms = 0;
         }
     }
+
+    // Same as calling debug(signal) for each of the samples. Whole 10 ms sums
+    // that do not complete a line are stored directly, only the sum that
+    // completes a line has to look at the clock.
+    void debug_run(int signal, uint32_t samples) {
+        while (samples > 0 && up_to_ten_ms > 0) {
+            debug(signal);
+            --samples;
+        }
+        while (samples >= 10 && char_count < characters_to_flush - 1) {
+            if (char_count == 0) { // begin of line
+                ++line_count;
+            }
+            line_sums[char_count] = 10 * signal;
+            ++char_count;
+            samples -= 10;
+        }
+        while (samples > 0) {
+            debug(signal);
+            --samples;
+        }
+    }
 }
 
+namespace raw_capture {
+    // The raw capture format stores one bit per 1 kHz sample, that is 125 bytes
+    // per second or ~10 MByte per week. The samples are packed least significant
+    // bit first. Thus on a little endian host the sample data can be read as
+    // uint64_t words with sample n in bit n%64 of word n/64. The sample data
+    // starts directly after the header which is 32 bytes long. Hence it will be
+    // properly aligned for 64 bit access if the file is mapped into memory.
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "raw capture format requires a little endian host");
+
+    enum polarity_t : uint8_t { active_high = 0, active_low = 1 };
+
+    struct header_t {
+        char     magic[8];           // "DCF77RAW"
+        uint16_t version;            // 1
+        uint16_t header_size;        // sizeof(header_t)
+        uint16_t sample_rate_hz;     // 1000
+        uint8_t  polarity;           // active_low --> samples must be inverted before processing
+
+        // start time of the capture, all 0 if unknown
+        uint8_t  year;               // 0..99
+        uint8_t  month;              // 1..12
+        uint8_t  day;                // 1..31
+        uint8_t  hour;               // 0..23
+        uint8_t  minute;             // 0..59
+        uint8_t  second;             // 0..60
+        uint8_t  uses_summertime;
+        uint8_t  reserved[2];
+
+        uint64_t sample_count;
+    };
+    static_assert(sizeof(header_t) == 32, "raw capture header must be 32 bytes");
+
+    const char magic[8] = { 'D', 'C', 'F', '7', '7', 'R', 'A', 'W' };
+    const uint16_t version = 1;
+    const uint16_t sample_rate_hz = 1000;
+
+    header_t make_header() {
+        header_t header = header_t();
+        memcpy(header.magic, magic, sizeof(header.magic));
+        header.version = version;
+        header.header_size = sizeof(header_t);
+        header.sample_rate_hz = sample_rate_hz;
+        header.polarity = active_high;
+        return header;
+    }
+
+    // Records each sample that is passed to record(). The sample count in the
+    // header is only known at the end, hence it is patched by close().
+    struct writer_t {
+        std::ofstream outfile;
+        header_t header;
+        uint8_t pending_bits = 0;
+
+        bool is_open() {
+            return outfile.is_open();
+        }
+
+        void open(const std::string &file_name, const header_t &start_header) {
+            header = start_header;
+            header.sample_count = 0;
+            pending_bits = 0;
+
+            outfile.open(file_name, std::ios::binary | std::ios::trunc);
+            assert("open capture file succeeded", outfile.good(), file_name);
+            outfile.write((const char *)&header, sizeof(header));
+        }
+
+        void record(const uint8_t signal) {
+            if (signal) {
+                pending_bits |= 1 << (header.sample_count % 8);
+            }
+            ++header.sample_count;
+            if (header.sample_count % 8 == 0) {
+                outfile.put(pending_bits);
+                pending_bits = 0;
+            }
+        }
+
+        void close() {
+            if (header.sample_count % 8) {
+                outfile.put(pending_bits);
+            }
+            outfile.seekp(0);
+            outfile.write((const char *)&header, sizeof(header));
+            assert("write capture file succeeded", outfile.good());
+            outfile.close();
+        }
+    } writer;
+}
+
+
 namespace Signal_Shaper {
-    unsigned long startup_ms = 0;
-    static std::mt19937_64 fade_prng(1);
-    static std::uniform_int_distribution<unsigned long> distribution_fade;
-    static std::uniform_int_distribution<unsigned long> distribution_gap;
+    // The signal shaper keeps its state per instance. Thus each simulation
+    // running in its own thread can have its own shaper. The Sink receives
+    // the shaped signal by means of flush(signal) and provides the frequency
+    // adjustment of the clock under test by means of read_adjustment().
+    template <typename Sink>
+    struct shaper_t {
+        Sink &sink;
+        const Test_Setup::signal_shaper_parameters_t &parameters;
 
-    static bool is_gap = false;
-    static unsigned long ms_to_go = 0;
+        unsigned long startup_ms = 0;
+        std::mt19937_64 fade_prng;
+        std::uniform_int_distribution<unsigned long> distribution_fade;
+        std::uniform_int_distribution<unsigned long> distribution_gap;
 
-    static std::mt19937_64 noise_prng(0);
-    static std::uniform_int_distribution<int> distribution_1000(0, 999);
-    static std::uniform_int_distribution<int> distribution_2(0, 1);
+        bool is_gap = false;
+        unsigned long ms_to_go = 0;
 
-    void setup() {
-        startup_ms = Test_Setup::signal_shaper_parameters.startup_ms;
-        is_gap = false;
-        ms_to_go = 0;
-
-        fade_prng.seed(1);
-        distribution_fade = std::uniform_int_distribution<unsigned long>((unsigned long) Test_Setup::signal_shaper_parameters.fade_min_ms , (unsigned long)Test_Setup::signal_shaper_parameters.fade_max_ms);
-        distribution_gap = std::uniform_int_distribution<unsigned long>((unsigned long)Test_Setup::signal_shaper_parameters.fade_min_gap_ms, (unsigned long)Test_Setup::signal_shaper_parameters.fade_max_gap_ms);
-        distribution_fade.reset();
-        distribution_gap.reset();
-
-        noise_prng.seed(0);
-        distribution_1000.reset();
-        distribution_2.reset();
-    };
+        std::mt19937_64 noise_prng;
+        std::uniform_int_distribution<int> distribution_1000 = std::uniform_int_distribution<int>(0, 999);
+        std::uniform_int_distribution<int> distribution_2    = std::uniform_int_distribution<int>(0, 1);
 
+        signed long cumulated_drift = 0;
 
-    void flush(const uint8_t signal) {
-        Scope::debug(signal);
-        Debug_Clock::process_1_kHz_tick_data(signal);
-    }
+        shaper_t(Sink &sink, const Test_Setup::signal_shaper_parameters_t &parameters) :
+            sink(sink), parameters(parameters) {}
 
-    void inject_random_hf_noise(const uint8_t signal) {
-        if (Test_Setup::signal_shaper_parameters.random_hf_noise_per_1000 > 0 &&
-            distribution_1000(noise_prng) < Test_Setup::signal_shaper_parameters.random_hf_noise_per_1000) {
+        void setup(const uint64_t fade_seed = 1, const uint64_t noise_seed = 0) {
+            startup_ms = parameters.startup_ms;
+            is_gap = false;
+            ms_to_go = 0;
+            cumulated_drift = 0;
 
-            flush(distribution_2(noise_prng));
-        } else {
-            flush(signal);
+            fade_prng.seed(fade_seed);
+            distribution_fade = std::uniform_int_distribution<unsigned long>((unsigned long) parameters.fade_min_ms , (unsigned long)parameters.fade_max_ms);
+            distribution_gap = std::uniform_int_distribution<unsigned long>((unsigned long)parameters.fade_min_gap_ms, (unsigned long)parameters.fade_max_gap_ms);
+            distribution_fade.reset();
+            distribution_gap.reset();
+
+            noise_prng.seed(noise_seed);
+            distribution_1000.reset();
+            distribution_2.reset();
+        };
+
+        void inject_random_hf_noise(const uint8_t signal) {
+            if (parameters.random_hf_noise_per_1000 > 0 &&
+                distribution_1000(noise_prng) < parameters.random_hf_noise_per_1000) {
+
+                sink.flush(distribution_2(noise_prng));
+            } else {
+                sink.flush(signal);
+            }
         }
-    }
 
+        void inject_fade(const uint8_t signal) {
+            if (parameters.fade_max_ms == 0 && parameters.fade_max_gap_ms == 0) {
+                // goto end
+            } else {
+                while (ms_to_go == 0) {
+                    is_gap = !is_gap;
+                    if (is_gap) {
+                        ms_to_go = distribution_gap(fade_prng);
+                    } else {
+                        ms_to_go = distribution_fade(fade_prng);
+                    }
+                }
+                --ms_to_go;
+                if (!is_gap) {
+                    inject_random_hf_noise(parameters.faded_signal);
+                    return;
+                }
+            }
+            inject_random_hf_noise(signal);
+        }
 
-    void inject_fade(const uint8_t signal) {
-        if (Test_Setup::signal_shaper_parameters.fade_max_ms == 0 && Test_Setup::signal_shaper_parameters.fade_max_gap_ms == 0) {
-            // goto end
-        } else {
-            while (ms_to_go == 0) {
-                is_gap = !is_gap;
-                if (is_gap) {
-                    ms_to_go = distribution_gap(fade_prng);
+        void inject_drift(const uint8_t signal) {
+            cumulated_drift += parameters.drift_pp16m;
+            cumulated_drift -= sink.read_adjustment();
+            if (cumulated_drift >= 16000000) {
+                cumulated_drift -= 16000000;
+
+                // clock is to fast, emulate this by skipping a sample
+                return;
+            }
+
+            if (cumulated_drift <= -16000000) {
+                cumulated_drift += 16000000;
+                // clock is to slow, emulate this by duplicating this sample
+
+                inject_fade(signal);
+            }
+
+            inject_fade(signal);
+        }
+
+        void process_1_kHz_tick_data(const uint8_t signal) {
+            while (startup_ms > 0) {
+                --startup_ms;
+                if (parameters.distort_startup_signal) {
+                    inject_drift(parameters.startup_signal);
                 } else {
-                    ms_to_go = distribution_fade(fade_prng);
+                    sink.flush(parameters.startup_signal);
                 }
             }
-            --ms_to_go;
-            if (!is_gap) {
-                inject_random_hf_noise(Test_Setup::signal_shaper_parameters.faded_signal);
-                return;
+
+            inject_drift(signal);
+        };
+
+        // Fades and noise must be applied sample by sample. Drift however only matters
+        // whenever the cumulated drift reaches a full sample. The samples in between
+        // can be passed to the sink in blocks or runs.
+        bool requires_single_samples() {
+            return startup_ms > 0 ||
+                   parameters.fade_max_ms > 0 || parameters.fade_max_gap_ms > 0 ||
+                   parameters.random_hf_noise_per_1000 > 0;
+        }
+
+        // number of samples before the cumulated drift reaches a full sample
+        uint64_t samples_before_drift(const int32_t drift, const uint64_t max_samples) {
+            uint64_t samples = max_samples;
+            if (drift > 0) { samples = min(samples, (uint64_t)((16000000 - 1 - cumulated_drift) /  drift)); }
+            if (drift < 0) { samples = min(samples, (uint64_t)((16000000 - 1 + cumulated_drift) / -drift)); }
+            return samples;
+        }
+
+        static const uint64_t block_words = 16;
+
+        // Block counterpart of process_1_kHz_tick_data for samples packed 64 per word,
+        // the first sample in the least significant bit. The sink returns how many
+        // samples of each block it did process. Thus it may stop early, e.g. if the
+        // clock under test changed its frequency adjustment.
+        void process_1_kHz_tick_data(const uint64_t *packed_samples, const uint64_t sample_count) {
+            const uint64_t word_count = (sample_count + 63) / 64;
+
+            uint64_t sample = 0;
+            while (sample < sample_count) {
+                const int32_t drift = parameters.drift_pp16m - sink.read_adjustment();
+                const uint64_t block_samples = samples_before_drift(drift, min(sample_count - sample, 64 * block_words));
+
+                if (requires_single_samples() || block_samples == 0) {
+                    process_1_kHz_tick_data((packed_samples[sample / 64] >> (sample % 64)) & 1);
+                    ++sample;
+                } else {
+                    // realign the block to start at bit 0
+                    uint64_t block[block_words];
+                    const uint64_t first_word = sample / 64;
+                    const uint8_t shift = sample % 64;
+                    for (uint64_t word = 0; word < (block_samples + 63) / 64; ++word) {
+                        block[word] = packed_samples[first_word + word] >> shift;
+                        if (shift > 0 && first_word + word + 1 < word_count) {
+                            block[word] |= packed_samples[first_word + word + 1] << (64 - shift);
+                        }
+                    }
+
+                    const uint64_t processed = sink.flush(block, block_samples);
+                    cumulated_drift += (signed long)processed * drift;
+                    sample += processed;
+                }
             }
         }
-        inject_random_hf_noise(signal);
-    }
 
+        // Constant run counterpart of process_1_kHz_tick_data. Just like for blocks
+        // the sink returns how many samples of each run it did process.
+        void process_1_kHz_tick_data_run(const uint8_t signal, const uint64_t sample_count) {
+            uint64_t sample = 0;
+            while (sample < sample_count) {
+                const int32_t drift = parameters.drift_pp16m - sink.read_adjustment();
+                const uint64_t run_samples = samples_before_drift(drift, min(sample_count - sample, (uint64_t)UINT32_MAX));
+
+                if (requires_single_samples() || run_samples == 0) {
+                    process_1_kHz_tick_data(signal);
+                    ++sample;
+                } else {
+                    const uint64_t processed = sink.flush_run(signal, run_samples);
+                    cumulated_drift += (signed long)processed * drift;
+                    sample += processed;
+                }
+            }
+        }
+    };
 
-    void inject_drift(const uint8_t signal) {
-        static signed long cumulated_drift = 0;
+    // sink of the single scenario run
+    struct debug_clock_sink_t {
+        void flush(const uint8_t signal) {
+            Scope::debug(signal);
+            Debug_Clock::process_1_kHz_tick_data(signal);
+        }
 
-        cumulated_drift += Test_Setup::signal_shaper_parameters.drift_pp16m;
-        cumulated_drift -= Internal::Generic_1_kHz_Generator::adjust_pp16m;
-        if (cumulated_drift >= 16000000) {
-            cumulated_drift -= 16000000;
+        uint32_t flush(const uint64_t *packed_samples, const uint32_t sample_count) {
+            // The scope looks at the clock before the clock processes the sample that
+            // completes a line. Thus a block must start with such a sample and must
+            // end before the next one. Apart from this the scope only sums up samples.
+            Scope::debug(packed_samples[0] & 1);
+            const uint32_t block_samples = min(sample_count, Scope::samples_to_next_line());
 
-            // clock is to fast, emulate this by skipping a sample
-            return;
+            const uint32_t processed = Debug_Clock::process_1_kHz_tick_data(packed_samples, block_samples);
+            for (uint32_t sample = 1; sample < processed; ++sample) {
+                Scope::debug((packed_samples[sample / 64] >> (sample % 64)) & 1);
+            }
+            return processed;
         }
 
-        if (cumulated_drift <= -16000000) {
-            cumulated_drift += 16000000;
-            // clock is to slow, emulate this by duplicating this sample
+        uint32_t flush_run(const uint8_t signal, const uint32_t sample_count) {
+            // same alignment to the scope lines as for blocks
+            Scope::debug(signal);
+            const uint32_t run_samples = min(sample_count, Scope::samples_to_next_line());
 
-            inject_fade(signal);
+            const uint32_t processed = Debug_Clock::process_1_kHz_tick_data_run(signal, run_samples);
+            Scope::debug_run(signal, processed - 1);
+            return processed;
         }
 
-        inject_fade(signal);
-    }
+        int16_t read_adjustment() {
+            return Debug_Clock::read_adjustment();
+        }
+    } debug_clock_sink;
 
+    shaper_t<debug_clock_sink_t> the_signal_shaper(debug_clock_sink, Test_Setup::signal_shaper_parameters);
 
+    void setup() {
+        the_signal_shaper.setup();
+    }
 
     void process_1_kHz_tick_data(const uint8_t signal) {
-        while (startup_ms > 0) {
-            --startup_ms;
-            if (Test_Setup::signal_shaper_parameters.distort_startup_signal) {
-                inject_drift(Test_Setup::signal_shaper_parameters.startup_signal);
-            } else {
-                flush(Test_Setup::signal_shaper_parameters.startup_signal);
+        if (raw_capture::writer.is_open()) {
+            raw_capture::writer.record(signal);
+        }
+        the_signal_shaper.process_1_kHz_tick_data(signal);
+    }
+
+    // Processes sample_count samples packed 64 per word, least significant bit first.
+    void process_1_kHz_tick_data(const uint64_t *packed_samples, const uint64_t sample_count) {
+        if (raw_capture::writer.is_open()) {
+            // the capture needs each single sample
+            for (uint64_t sample = 0; sample < sample_count; ++sample) {
+                process_1_kHz_tick_data((packed_samples[sample / 64] >> (sample % 64)) & 1);
             }
+        } else {
+            the_signal_shaper.process_1_kHz_tick_data(packed_samples, sample_count);
         }
+    }
 
-        inject_drift(signal);
-    };
+    // Processes sample_count samples of identical value.
+    void process_1_kHz_tick_data_run(const uint8_t signal, const uint64_t sample_count) {
+        if (raw_capture::writer.is_open()) {
+            for (uint64_t sample = 0; sample < sample_count; ++sample) {
+                process_1_kHz_tick_data(signal);
+            }
+        } else {
+            the_signal_shaper.process_1_kHz_tick_data_run(signal, sample_count);
+        }
+    }
+
+    // the input of the single scenario run, synthesize_signal() feeds it
+    struct signal_input_t {
+        void process_1_kHz_tick_data(const uint8_t signal) {
+            Signal_Shaper::process_1_kHz_tick_data(signal);
+        }
+    } signal_input;
 }
 
+
 namespace dcf77_log_de_parser {
     void generate_signal(uint16_t ms, uint8_t data) {
-        for (uint16_t count = 0; count < ms; ++count) {
-            Signal_Shaper::process_1_kHz_tick_data(data);
-        }
+        Signal_Shaper::process_1_kHz_tick_data_run(data, ms);
     };
 
     void push_gap_to_clock_controller() {
@@ -843,24 +1401,84 @@ namespace swiss_army_debug_helper_scope_parser {
 }
 
 
-void synthesize_signal() {
-    Internal::DCF77_Encoder now;
+namespace raw_capture {
+    // The capture file is mapped into memory and the samples are handed over
+    // to the signal shaper in blocks. Thus replay runs at memory bandwidth
+    // instead of istream speed.
+    const uint64_t block_words = 1024;
+
+    void replay(const std::string &file_name) {
+        assert("raw capture requires an input file", file_name != "");
+
+        const int fd = open(file_name.c_str(), O_RDONLY);
+        assert("open file succeeded", fd >= 0, file_name);
+
+        struct stat file_status;
+        assert("stat file succeeded", fstat(fd, &file_status) == 0, file_name);
+        const uint64_t file_size = file_status.st_size;
+        assert("file contains capture header", file_size >= sizeof(header_t), file_name);
+
+        void *mapped = mmap(0, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        assert("mmap file succeeded", mapped != MAP_FAILED, file_name);
+        close(fd);
+        madvise(mapped, file_size, MADV_SEQUENTIAL);
+
+        const header_t &header = *(const header_t *)mapped;
+        assert("capture magic", memcmp(header.magic, magic, sizeof(magic)) == 0, file_name);
+        assert("capture version", header.version == version, header.version);
+        assert("capture header size", header.header_size == sizeof(header_t), header.header_size);
+        assert("capture sample rate", header.sample_rate_hz == sample_rate_hz, header.sample_rate_hz);
+        assert("capture polarity", header.polarity <= active_low, (int)header.polarity);
+        assert("capture contains all samples", (file_size - sizeof(header_t)) * 8 >= header.sample_count, header.sample_count);
+
+        const uint8_t *samples = (const uint8_t *)mapped + sizeof(header_t);
+        const uint64_t polarity_mask = header.polarity == active_low ? ~(uint64_t)0 : 0;
+
+        uint64_t block[block_words];
+        for (uint64_t sample = 0; sample < header.sample_count; sample += 64 * block_words) {
+            const uint64_t block_samples = min(header.sample_count - sample, 64 * block_words);
+            const uint64_t block_bytes = (block_samples + 7) / 8;
+
+            // the last word of the file might be incomplete
+            block[(block_bytes - 1) / 8] = 0;
+            memcpy(block, samples + sample / 8, block_bytes);
+            if (polarity_mask) {
+                for (uint64_t word = 0; word < (block_samples + 63) / 64; ++word) {
+                    block[word] ^= polarity_mask;
+                }
+            }
+            Signal_Shaper::process_1_kHz_tick_data(block, block_samples);
+        }
+
+        munmap(mapped, file_size);
+    }
+}
 
-    now.year    = BCD::int_to_bcd(Test_Setup::synthesizer_parameters.year);
-    now.month   = BCD::int_to_bcd(Test_Setup::synthesizer_parameters.month);
-    now.day     = BCD::int_to_bcd(Test_Setup::synthesizer_parameters.day);
-    now.weekday = BCD::int_to_bcd(Test_Setup::synthesizer_parameters.weekday);
-    now.hour    = BCD::int_to_bcd(Test_Setup::synthesizer_parameters.hour);
-    now.minute  = BCD::int_to_bcd(Test_Setup::synthesizer_parameters.minute);
-    now.second  =                 Test_Setup::synthesizer_parameters.second;
 
-    now.uses_summertime =                Test_Setup::synthesizer_parameters.uses_summertime;
-    now.abnormal_transmitter_operation = Test_Setup::synthesizer_parameters.abnormal_transmitter_operation;
-    now.timezone_change_scheduled =      Test_Setup::synthesizer_parameters.timezone_change_scheduled;
-    now.leap_second_scheduled =          Test_Setup::synthesizer_parameters.leap_second_scheduled;
+// Sets the encoder to the start time of the synthesized signal.
+void setup_synthesizer(const Test_Setup::synthesizer_parameters_t &synthesizer_parameters, Internal::DCF77_Encoder &now) {
+    // reset first, otherwise the undefined_*_output flags are stack garbage
+    now.reset();
 
+    now.year    = BCD::int_to_bcd(synthesizer_parameters.year);
+    now.month   = BCD::int_to_bcd(synthesizer_parameters.month);
+    now.day     = BCD::int_to_bcd(synthesizer_parameters.day);
+    now.weekday = BCD::int_to_bcd(synthesizer_parameters.weekday);
+    now.hour    = BCD::int_to_bcd(synthesizer_parameters.hour);
+    now.minute  = BCD::int_to_bcd(synthesizer_parameters.minute);
+    now.second  =                 synthesizer_parameters.second;
 
-    for (unsigned long i = 0; i < Test_Setup::synthesizer_parameters.synthesized_signal_length; ++i) {
+    now.uses_summertime =                synthesizer_parameters.uses_summertime;
+    now.abnormal_transmitter_operation = synthesizer_parameters.abnormal_transmitter_operation;
+    now.timezone_change_scheduled =      synthesizer_parameters.timezone_change_scheduled;
+    now.leap_second_scheduled =          synthesizer_parameters.leap_second_scheduled;
+}
+
+// Feeds the given number of seconds of synthesized signal into sink.process_1_kHz_tick_data().
+// The encoder is advanced accordingly, thus the synthesis can be continued later on.
+template <typename Signal_Sink>
+void synthesize_signal(Internal::DCF77_Encoder &now, const unsigned long seconds, Signal_Sink &sink) {
+    for (unsigned long i = 0; i < seconds; ++i) {
         Internal::DCF77::tick_t decoded_signal = now.get_current_signal();
 
         for (int ms = 0; ms < 1000; ++ms) {
@@ -870,17 +1488,29 @@ void synthesize_signal() {
             if (decoded_signal == Internal::DCF77::short_tick && (             ms < 100)) { signal = 1; }
             //(if (decoded_signal == Internal::DCF77::undefined  && (100 <= ms && ms < 200)) { signal = 1; }
 
-            if (Scope::next_line() && Test_Setup::verbosity.show_synthesizer == Test_Setup::always) {
+            if (Test_Setup::verbosity.show_synthesizer == Test_Setup::always && Scope::next_line()) {
                 print("next second will be: ");
                 now.debug();
                 println();
             }
-            Signal_Shaper::process_1_kHz_tick_data(signal);
+            sink.process_1_kHz_tick_data(signal);
         }
         now.advance_second();
     }
 }
 
+// Feeds the synthesized signal into sink.process_1_kHz_tick_data().
+template <typename Signal_Sink>
+void synthesize_signal(const Test_Setup::synthesizer_parameters_t &synthesizer_parameters, Signal_Sink &sink) {
+    Internal::DCF77_Encoder now;
+    setup_synthesizer(synthesizer_parameters, now);
+    synthesize_signal(now, synthesizer_parameters.synthesized_signal_length, sink);
+}
+
+void synthesize_signal() {
+    synthesize_signal(Test_Setup::synthesizer_parameters, Signal_Shaper::signal_input);
+}
+
 void output_handler(const Clock::time_t &decoded_time) {
     Scope::output_triggered = true;
 }
@@ -906,7 +1536,9 @@ void read_file_content(std::istream & infile) {
 
 void read_signal_from_file() {
     using namespace Test_Setup;
-    if (file_name == "") {
+    if (file_format == Test_Setup::bit_packed_capture) {
+        raw_capture::replay(file_name);
+    } else if (file_name == "") {
         read_file_content(std::cin);
     } else {
         std::ifstream infile(file_name);
@@ -1022,15 +1654,557 @@ void boilerplate(int argc, char** argv) {
 
 
 void tombstone() {
+    Scope::flush();
     Test_Setup::verbosity.show_debug_info = Test_Setup::always;
     println("\nFinal Clock State");
     Scope::second_tick_info(true);
 
     Statistics::dump();
+    if (Tick_Profiler::enabled) {
+        Tick_Profiler::dump();
+    }
     println();
 }
 
 
+namespace Sweep {
+    // The sweep runs one scenario per cell of the grid
+    //     drift_pp16m x random_hf_noise_per_1000 x fade x millisecond_samples.
+    // Each cell owns its clock controller, its signal shaper and its statistics.
+    // Hence the cells are distributed over a pool of worker threads which share
+    // nothing but the (read only) test setup.
+    struct fade_t {
+        unsigned long fade_min_ms     = 0;
+        unsigned long fade_max_ms     = 0;
+        unsigned long fade_min_gap_ms = 0;
+        unsigned long fade_max_gap_ms = 0;
+        int           faded_signal    = 0;
+    };
+
+    // axes of the grid, an empty axis will use the value of the single scenario options
+    std::vector<signed int>   drift_pp16m;
+    std::vector<unsigned int> random_hf_noise_per_1000;
+    std::vector<fade_t>       fade;
+    std::vector<bool>         high_phase_lock_resolution;
+
+    unsigned int jobs = 0;  // 0 --> one worker per core
+
+    bool enabled() {
+        return !drift_pp16m.empty() || !random_hf_noise_per_1000.empty() ||
+               !fade.empty()        || !high_phase_lock_resolution.empty();
+    }
+
+    struct cell_t {
+        bool high_phase_lock_resolution;
+        Test_Setup::signal_shaper_parameters_t signal_shaper_parameters;
+    };
+
+    struct result_t {
+        // seconds till the clock state was reached for the first time, -1 --> never
+        long time_to_dirty      = -1;  // any state but useless
+        long time_to_first_sync = -1;
+        long time_to_locked     = -1;  // locked or synced
+        long time_to_sync_lost  = -1;  // first transition from synced to any other state
+
+        // seconds where the clock was at least free but showed a time other than the synthesized one
+        unsigned long wrong_time_s = 0;
+        Clock::clock_state_t final_clock_state = Clock::useless;
+        Statistics::counters_t statistics;
+    };
+
+    template <typename Clock_Controller>
+    struct runner_t {
+        Clock_Controller clock_controller;
+        Signal_Shaper::shaper_t<runner_t> signal_shaper;
+        result_t &result;
+
+        unsigned long seconds = 0;
+        uint16_t ms = 0;
+        Clock::clock_state_t prev_state = Clock::useless;
+
+        // the synthesized time, i.e. the time the signal announces for the next minute
+        Internal::DCF77_Encoder expected_time;
+        uint16_t synthesized_ms = 0;
+
+        runner_t(const cell_t &cell, result_t &result) :
+            signal_shaper(*this, cell.signal_shaper_parameters), result(result) {}
+
+        // seed 0 results in the same random sequences as the single scenario run
+        void setup_signal_shaper(const uint64_t seed) {
+            signal_shaper.setup(2*seed + 1, 2*seed);
+        }
+
+        void setup(const Internal::DCF77_Encoder &start_time, const uint64_t seed = 0) {
+            clock_controller.setup();
+            setup_signal_shaper(seed);
+            expected_time = start_time;
+            synthesized_ms = 0;
+        }
+
+        // input of the runner, the synthesizer feeds it
+        void process_1_kHz_tick_data(const uint8_t signal) {
+            if (synthesized_ms == 500) {
+                // in the middle of the second the phase of the clock does not matter
+                check_time();
+            }
+            signal_shaper.process_1_kHz_tick_data(signal);
+
+            if (++synthesized_ms == 1000) {
+                synthesized_ms = 0;
+                expected_time.advance_second();
+            }
+        }
+
+        void check_time() {
+            if (clock_controller.get_clock_state() >= Clock::free) {
+                Internal::DCF77_Encoder now;
+                clock_controller.read_current_time(now);
+                // the signal always announces the next minute
+                now.advance_minute();
+                if (now.second     != expected_time.second     ||
+                    now.minute.val != expected_time.minute.val ||
+                    now.hour.val   != expected_time.hour.val   ||
+                    now.day.val    != expected_time.day.val    ||
+                    now.month.val  != expected_time.month.val  ||
+                    now.year.val   != expected_time.year.val) {
+
+                    ++result.wrong_time_s;
+                }
+            }
+        }
+
+        void flush(const uint8_t signal) {
+            // sample at the same point in time as Scope::debug_10ms,
+            // thus the statistics will match the single scenario run
+            if (++ms == 1000) {
+                ms = 0;
+                ++seconds;
+                sample();
+            }
+            clock_controller.process_1_kHz_tick_data(signal);
+        }
+
+        int16_t read_adjustment() {
+            return clock_controller.Frequency_Control.read_adjustment();
+        }
+
+        void sample() {
+            const Clock::clock_state_t clock_state = clock_controller.get_clock_state();
+            result.statistics.sample(prev_state, clock_state,
+                                     clock_controller.get_overall_quality_factor(),
+                                     clock_controller.get_prediction_match());
+
+            if (result.time_to_dirty < 0 && clock_state != Clock::useless) {
+                result.time_to_dirty = seconds;
+            }
+            if (result.time_to_first_sync < 0 && clock_state == Clock::synced) {
+                result.time_to_first_sync = seconds;
+            }
+            if (result.time_to_locked < 0 && (clock_state == Clock::locked || clock_state == Clock::synced)) {
+                result.time_to_locked = seconds;
+            }
+            if (result.time_to_sync_lost < 0 && prev_state == Clock::synced && clock_state != Clock::synced) {
+                result.time_to_sync_lost = seconds;
+            }
+            prev_state = clock_state;
+        }
+
+        void run(const uint64_t seed = 0) {
+            Internal::DCF77_Encoder now;
+            setup_synthesizer(Test_Setup::synthesizer_parameters, now);
+            setup(now, seed);
+            synthesize_signal(now, Test_Setup::synthesizer_parameters.synthesized_signal_length, *this);
+            result.final_clock_state = clock_controller.get_clock_state();
+        }
+
+        // Everything a continuation of the run needs except for the synthesizer state.
+        // The fades and the noise of the shaper are not kept, a continuation is
+        // supposed to use its own random sequences anyway.
+        struct snapshot_t {
+            uint8_t clock_controller[Clock_Controller::snapshot_size];
+            signed long cumulated_drift;
+            unsigned long seconds;
+            uint16_t ms;
+            Clock::clock_state_t prev_state;
+            Internal::DCF77_Encoder expected_time;
+            uint16_t synthesized_ms;
+            result_t result;
+        };
+
+        void save_snapshot(snapshot_t &snapshot) const {
+            clock_controller.save_snapshot(snapshot.clock_controller);
+            snapshot.cumulated_drift = signal_shaper.cumulated_drift;
+            snapshot.seconds = seconds;
+            snapshot.ms = ms;
+            snapshot.prev_state = prev_state;
+            snapshot.expected_time = expected_time;
+            snapshot.synthesized_ms = synthesized_ms;
+            snapshot.result = result;
+        }
+
+        void restore_snapshot(const snapshot_t &snapshot, const uint64_t seed) {
+            clock_controller.restore_snapshot(snapshot.clock_controller);
+            setup_signal_shaper(seed);
+            signal_shaper.startup_ms = 0;
+            signal_shaper.cumulated_drift = snapshot.cumulated_drift;
+            seconds = snapshot.seconds;
+            ms = snapshot.ms;
+            prev_state = snapshot.prev_state;
+            expected_time = snapshot.expected_time;
+            synthesized_ms = snapshot.synthesized_ms;
+            result = snapshot.result;
+        }
+    };
+
+    template <typename Clock_Controller>
+    void run_cell(const cell_t &cell, result_t &result, const uint64_t seed) {
+        // allocate on the heap, the hires controller would eat up quite some of the thread's stack
+        std::unique_ptr<runner_t<Clock_Controller> > runner(new runner_t<Clock_Controller>(cell, result));
+        runner->run(seed);
+    }
+
+    void run_cell(const cell_t &cell, result_t &result, const uint64_t seed = 0) {
+        if (cell.high_phase_lock_resolution) {
+            run_cell<Debug_Clock::Clock_Controller_hires>(cell, result, seed);
+        } else {
+            run_cell<Debug_Clock::Clock_Controller_lores>(cell, result, seed);
+        }
+    }
+
+    void setup_grid(std::vector<cell_t> &cells) {
+        using namespace Test_Setup;
+        if (drift_pp16m.empty())                { drift_pp16m.push_back(signal_shaper_parameters.drift_pp16m); }
+        if (random_hf_noise_per_1000.empty())   { random_hf_noise_per_1000.push_back(signal_shaper_parameters.random_hf_noise_per_1000); }
+        if (high_phase_lock_resolution.empty()) { Sweep::high_phase_lock_resolution.push_back(Test_Setup::high_phase_lock_resolution); }
+        if (fade.empty()) {
+            fade_t f;
+            f.fade_min_ms     = signal_shaper_parameters.fade_min_ms;
+            f.fade_max_ms     = signal_shaper_parameters.fade_max_ms;
+            f.fade_min_gap_ms = signal_shaper_parameters.fade_min_gap_ms;
+            f.fade_max_gap_ms = signal_shaper_parameters.fade_max_gap_ms;
+            f.faded_signal    = signal_shaper_parameters.faded_signal;
+            fade.push_back(f);
+        }
+
+        for (const bool hires : Sweep::high_phase_lock_resolution) {
+            for (const fade_t &f : fade) {
+                for (const unsigned int noise : random_hf_noise_per_1000) {
+                    for (const signed int drift : drift_pp16m) {
+                        cell_t cell;
+                        cell.high_phase_lock_resolution = hires;
+                        cell.signal_shaper_parameters = signal_shaper_parameters;
+                        cell.signal_shaper_parameters.drift_pp16m              = drift;
+                        cell.signal_shaper_parameters.random_hf_noise_per_1000 = noise;
+                        cell.signal_shaper_parameters.fade_min_ms              = f.fade_min_ms;
+                        cell.signal_shaper_parameters.fade_max_ms              = f.fade_max_ms;
+                        cell.signal_shaper_parameters.fade_min_gap_ms          = f.fade_min_gap_ms;
+                        cell.signal_shaper_parameters.fade_max_gap_ms          = f.fade_max_gap_ms;
+                        cell.signal_shaper_parameters.faded_signal             = f.faded_signal;
+                        cells.push_back(cell);
+                    }
+                }
+            }
+        }
+    }
+
+    // runs job(0) .. job(count-1) on a pool of worker threads
+    template <typename Job>
+    void run_parallel(const size_t count, const Job &job) {
+        const unsigned int workers = jobs > 0? jobs: std::max(1u, std::thread::hardware_concurrency());
+
+        std::atomic<size_t> next_job(0);
+        std::vector<std::thread> pool;
+        for (unsigned int worker = 0; worker < workers; ++worker) {
+            pool.emplace_back([count, &job, &next_job]() {
+                for (size_t i = next_job++; i < count; i = next_job++) {
+                    job(i);
+                }
+            });
+        }
+        for (std::thread &thread : pool) {
+            thread.join();
+        }
+    }
+
+    void run_all(const std::vector<cell_t> &cells, std::vector<result_t> &results) {
+        run_parallel(cells.size(), [&cells, &results](const size_t cell) {
+            run_cell(cells[cell], results[cell]);
+        });
+    }
+
+    const char * const csv_parameter_header =
+        "millisecond_samples,drift_pp16m,random_hf_noise_per_1000,"
+        "fade_min_ms,fade_max_ms,fade_min_gap_ms,fade_max_gap_ms,faded_signal";
+
+    const char * const csv_result_header =
+        "time_to_first_sync_s,time_to_locked_s,final_clock_state,"
+        "useless_s,dirty_s,free_s,unlocked_s,locked_s,synced_s,state_changes,"
+        "quality_factor_average,prediction_match_average,wrong_time_s";
+
+    // the parameter columns of a CSV row
+    void dump(const cell_t &cell) {
+        const Test_Setup::signal_shaper_parameters_t &parameters = cell.signal_shaper_parameters;
+
+        std::cout << cell.high_phase_lock_resolution << ','
+                  << parameters.drift_pp16m << ','
+                  << parameters.random_hf_noise_per_1000 << ','
+                  << parameters.fade_min_ms << ','
+                  << parameters.fade_max_ms << ','
+                  << parameters.fade_min_gap_ms << ','
+                  << parameters.fade_max_gap_ms << ','
+                  << parameters.faded_signal;
+    }
+
+    // one CSV row without line end
+    void dump(const cell_t &cell, const result_t &result) {
+        unsigned long state_changes = 0;
+        for (uint8_t from = 0; from < 6; ++from) {
+            for (uint8_t to = 0; to < 6; ++to) {
+                if (from != to) { state_changes += result.statistics.clock_transition_count[from][to]; }
+            }
+        }
+
+        dump(cell);
+        std::cout << ',' << result.time_to_first_sync << ','
+                  << result.time_to_locked << ','
+                  << (int)result.final_clock_state;
+        for (uint8_t state = 0; state < 6; ++state) {
+            std::cout << ',' << result.statistics.clock_state_count[state];
+        }
+        std::cout << ',' << state_changes
+                  << ',' << Statistics::average(result.statistics.quality_factor_count)
+                  << ',' << Statistics::average(result.statistics.prediction_match_count)
+                  << ',' << result.wrong_time_s;
+    }
+
+    void dump(const std::vector<cell_t> &cells, const std::vector<result_t> &results) {
+        std::cout << csv_parameter_header << ',' << csv_result_header << '\n';
+        for (size_t i = 0; i < cells.size(); ++i) {
+            dump(cells[i], results[i]);
+            std::cout << '\n';
+        }
+        std::cout.flush();
+    }
+
+    void run() {
+        if (Test_Setup::signal_source != Test_Setup::synthesizer) {
+            println("sweeps are only supported for the signal synthesizer (--input=0)");
+            exit(4);
+        }
+
+        std::vector<cell_t> cells;
+        setup_grid(cells);
+
+        std::vector<result_t> results(cells.size());
+        run_all(cells, results);
+
+        dump(cells, results);
+    }
+}
+
+namespace Fork {
+    // The fork runs the single scenario until the clock is synced for the first time.
+    // Then it snapshots the runner and continues from the snapshot once per seed and
+    // per cell of the sweep grid. Thus all continuations start from the very same
+    // synced state but see their own perturbations: fades and noise from their own
+    // seed and a drift step if the drift of the cell differs from the scenario drift.
+    // The continuations share nothing but the (read only) snapshot, hence they are
+    // distributed over the worker threads of the sweep.
+    unsigned int continuations = 0;  // per cell, 0 --> no fork
+
+    bool enabled() {
+        return continuations > 0;
+    }
+
+    template <typename Clock_Controller>
+    struct fork_t {
+        typedef Sweep::runner_t<Clock_Controller> runner_t;
+
+        typename runner_t::snapshot_t snapshot;
+        Internal::DCF77_Encoder now;
+        unsigned long synthesized_seconds = 0;
+
+        // returns false if the scenario never reaches Clock::synced
+        bool run_until_synced() {
+            Sweep::cell_t cell;
+            cell.high_phase_lock_resolution = Test_Setup::high_phase_lock_resolution;
+            cell.signal_shaper_parameters = Test_Setup::signal_shaper_parameters;
+
+            Sweep::result_t result;
+            std::unique_ptr<runner_t> runner(new runner_t(cell, result));
+            setup_synthesizer(Test_Setup::synthesizer_parameters, now);
+            runner->setup(now);
+
+            while (synthesized_seconds < Test_Setup::synthesizer_parameters.synthesized_signal_length) {
+                synthesize_signal(now, 1, *runner);
+                ++synthesized_seconds;
+                if (runner->clock_controller.get_clock_state() == Clock::synced) {
+                    runner->save_snapshot(snapshot);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void run_continuation(const Sweep::cell_t &cell, const uint64_t seed, Sweep::result_t &result) const {
+            std::unique_ptr<runner_t> runner(new runner_t(cell, result));
+            runner->restore_snapshot(snapshot, seed);
+
+            Internal::DCF77_Encoder continued_now = now;
+            synthesize_signal(continued_now, Test_Setup::synthesizer_parameters.synthesized_signal_length - synthesized_seconds,
+                              *runner);
+            result.final_clock_state = runner->clock_controller.get_clock_state();
+        }
+
+        void run() {
+            if (!run_until_synced()) {
+                println("the scenario never reached the synced state, nothing to fork");
+                exit(4);
+            }
+
+            std::vector<Sweep::cell_t> cells;
+            Sweep::setup_grid(cells);
+
+            std::vector<Sweep::result_t> results(cells.size() * continuations);
+            Sweep::run_parallel(results.size(), [this, &cells, &results](const size_t i) {
+                run_continuation(cells[i / continuations], i % continuations, results[i]);
+            });
+
+            std::cout << "fork_second,seed," << Sweep::csv_parameter_header << ',' << Sweep::csv_result_header
+                      << ",time_to_sync_lost_s\n";
+            for (size_t i = 0; i < results.size(); ++i) {
+                std::cout << synthesized_seconds << ',' << i % continuations << ',';
+                Sweep::dump(cells[i / continuations], results[i]);
+                std::cout << ',' << results[i].time_to_sync_lost << '\n';
+            }
+            std::cout.flush();
+        }
+    };
+
+    void run() {
+        if (Test_Setup::signal_source != Test_Setup::synthesizer) {
+            println("forks are only supported for the signal synthesizer (--input=0)");
+            exit(4);
+        }
+        if (!Sweep::high_phase_lock_resolution.empty()) {
+            println("the filter parameters can not change within a fork, use --millisecond_samples instead");
+            exit(4);
+        }
+
+        // allocate on the heap, the snapshot of the hires controller is quite large
+        if (Test_Setup::high_phase_lock_resolution) {
+            std::unique_ptr<fork_t<Debug_Clock::Clock_Controller_hires> > fork(new fork_t<Debug_Clock::Clock_Controller_hires>());
+            fork->run();
+        } else {
+            std::unique_ptr<fork_t<Debug_Clock::Clock_Controller_lores> > fork(new fork_t<Debug_Clock::Clock_Controller_lores>());
+            fork->run();
+        }
+    }
+}
+
+
+namespace Monte_Carlo {
+    // A single seed tells nothing about the tails. Hence the Monte Carlo simulation
+    // runs each cell of the sweep grid with n seeds for the fades and the noise and
+    // reports the distribution of the times till the clock is dirty, locked and
+    // synced. Seed 0 is the seed of the single scenario run.
+    unsigned int seeds = 0;  // per cell, 0 --> no Monte Carlo simulation
+
+    bool enabled() {
+        return seeds > 0;
+    }
+
+    // just what is needed for the distributions, thousands of full results would eat up too much memory
+    struct sample_t {
+        long time_to_dirty;
+        long time_to_locked;
+        long time_to_first_sync;
+        unsigned long wrong_time_s;
+    };
+
+    // nearest rank percentile of the times, -1 --> the state was never reached
+    long percentile(std::vector<long> times, const unsigned int percent) {
+        for (long &time : times) {
+            if (time < 0) { time = LONG_MAX; }
+        }
+        std::sort(times.begin(), times.end());
+
+        const long time = times[(times.size() * percent + 99) / 100 - 1];
+        return time == LONG_MAX? -1: time;
+    }
+
+    void dump_distribution(const std::vector<long> &times) {
+        unsigned long never = 0;
+        for (const long time : times) {
+            never += time < 0;
+        }
+        std::cout << ',' << percentile(times, 50)
+                  << ',' << percentile(times, 90)
+                  << ',' << percentile(times, 99)
+                  << ',' << never;
+    }
+
+    void dump(const Sweep::cell_t &cell, const sample_t *samples) {
+        std::vector<long> time_to_dirty;
+        std::vector<long> time_to_locked;
+        std::vector<long> time_to_first_sync;
+        unsigned long wrong_time_runs = 0;
+        unsigned long wrong_time_s = 0;
+        unsigned long wrong_time_max_s = 0;
+        for (unsigned int seed = 0; seed < seeds; ++seed) {
+            const sample_t &sample = samples[seed];
+            time_to_dirty.push_back(sample.time_to_dirty);
+            time_to_locked.push_back(sample.time_to_locked);
+            time_to_first_sync.push_back(sample.time_to_first_sync);
+            wrong_time_runs += sample.wrong_time_s > 0;
+            wrong_time_s += sample.wrong_time_s;
+            wrong_time_max_s = std::max(wrong_time_max_s, sample.wrong_time_s);
+        }
+
+        Sweep::dump(cell);
+        std::cout << ',' << seeds;
+        dump_distribution(time_to_dirty);
+        dump_distribution(time_to_locked);
+        dump_distribution(time_to_first_sync);
+        std::cout << ',' << wrong_time_runs
+                  << ',' << wrong_time_s
+                  << ',' << wrong_time_max_s
+                  << '\n';
+    }
+
+    void run() {
+        if (Test_Setup::signal_source != Test_Setup::synthesizer) {
+            println("Monte Carlo simulations are only supported for the signal synthesizer (--input=0)");
+            exit(4);
+        }
+
+        std::vector<Sweep::cell_t> cells;
+        Sweep::setup_grid(cells);
+
+        std::vector<sample_t> samples(cells.size() * seeds);
+        Sweep::run_parallel(samples.size(), [&cells, &samples](const size_t i) {
+            Sweep::result_t result;
+            Sweep::run_cell(cells[i / seeds], result, i % seeds);
+
+            samples[i].time_to_dirty      = result.time_to_dirty;
+            samples[i].time_to_locked     = result.time_to_locked;
+            samples[i].time_to_first_sync = result.time_to_first_sync;
+            samples[i].wrong_time_s       = result.wrong_time_s;
+        });
+
+        std::cout << Sweep::csv_parameter_header << ",seeds,"
+                     "dirty_p50_s,dirty_p90_s,dirty_p99_s,dirty_never,"
+                     "locked_p50_s,locked_p90_s,locked_p99_s,locked_never,"
+                     "synced_p50_s,synced_p90_s,synced_p99_s,synced_never,"
+                     "wrong_time_runs,wrong_time_s,wrong_time_max_s\n";
+        for (size_t cell = 0; cell < cells.size(); ++cell) {
+            dump(cells[cell], &samples[cell * seeds]);
+        }
+        std::cout.flush();
+    }
+}
+
+
 void run(int argc, char **argv) {
     boilerplate(argc, argv);
 
@@ -1039,12 +2213,32 @@ void run(int argc, char **argv) {
 
     Signal_Shaper::setup();
 
+    if (Test_Setup::capture_file_name != "") {
+        raw_capture::header_t header = raw_capture::make_header();
+        if (Test_Setup::signal_source == Test_Setup::synthesizer) {
+            // the start time is only known for synthesized signals
+            const Test_Setup::synthesizer_parameters_t &synthesizer_parameters = Test_Setup::synthesizer_parameters;
+            header.year            = synthesizer_parameters.year;
+            header.month           = synthesizer_parameters.month;
+            header.day             = synthesizer_parameters.day;
+            header.hour            = synthesizer_parameters.hour;
+            header.minute          = synthesizer_parameters.minute;
+            header.second          = synthesizer_parameters.second;
+            header.uses_summertime = synthesizer_parameters.uses_summertime;
+        }
+        raw_capture::writer.open(Test_Setup::capture_file_name, header);
+    }
+
     switch (Test_Setup::signal_source) {
         case Test_Setup::filesystem  : read_signal_from_file(); break;
         case Test_Setup::synthesizer : synthesize_signal();     break;
         default: assert("signal source has valid value", false, Test_Setup::signal_source);
     }
 
+    if (raw_capture::writer.is_open()) {
+        raw_capture::writer.close();
+    }
+
     tombstone();
 }
 
@@ -1192,6 +2386,66 @@ void parse_fade_parameters(long unsigned &p0,
     p4 = l_p[4];
 }
 
+// parses a comma separated list of values and ranges, e.g. -300,-100:100:50,300
+// ranges are given as from:to:step
+template <typename T>
+void parse_sweep_list(const std::string token_name, short int max_len, const signed long min_value, const signed long max_value,
+                      std::string input, std::vector<T> &values) {
+    std::string::size_type pos;
+    do {
+        pos = input.find(',');
+        const std::string item = input.substr(0, pos);
+        input = pos == std::string::npos? "": input.substr(pos + 1);
+
+        signed long from, to, step = 1;
+        const std::string::size_type first_colon = item.find(':');
+        if (first_colon == std::string::npos) {
+            from = to = parse_signed(token_name, 1, max_len, 10, item);
+        } else {
+            const std::string::size_type second_colon = item.find(':', first_colon + 1);
+            if (second_colon == std::string::npos) {
+                print("missing step in range ");
+                print(item);
+                print(" for token ");
+                println(token_name);
+                exit(4);
+            }
+            from = parse_signed(token_name, 1, max_len, 10, item.substr(0, first_colon));
+            to   = parse_signed(token_name, 1, max_len, 10, item.substr(first_colon + 1, second_colon - first_colon - 1));
+            step = parse_unsigned(token_name, 1, max_len, 10, item.substr(second_colon + 1));
+            if (step == 0) {
+                print("step must not be 0 for token ");
+                println(token_name);
+                exit(4);
+            }
+        }
+
+        for (signed long value = from; value <= to; value += step) {
+            if (value < min_value || value > max_value) {
+                print("value ");
+                print(value);
+                print(" out of range for token ");
+                println(token_name);
+                exit(4);
+            }
+            values.push_back((T) value);
+        }
+    } while (pos != std::string::npos);
+}
+
+// parses a slash separated list of fade parameters, e.g. 0,0,0,0,0/100,500,1000,3000,0
+void parse_sweep_fade(std::string input) {
+    std::string::size_type pos;
+    do {
+        pos = input.find('/');
+        Sweep::fade_t fade;
+        parse_fade_parameters(fade.fade_min_ms, fade.fade_max_ms, fade.fade_min_gap_ms, fade.fade_max_gap_ms, fade.faded_signal,
+                              input.substr(0, pos));
+        Sweep::fade.push_back(fade);
+        input = pos == std::string::npos? "": input.substr(pos + 1);
+    } while (pos != std::string::npos);
+}
+
 void parse_verbosity(std::string options) {
     using namespace Test_Setup;
     for (uint8_t i=0; i< 255 && i < options.length(); ++i) {
@@ -1200,9 +2454,10 @@ void parse_verbosity(std::string options) {
             case 'd': verbosity.show_debug_info  = verbosity.show_debug_info  == quiet ? event_triggered : always; break;
             case 's': verbosity.show_debug_scope =                                                         always; break;
             case 'y': verbosity.show_synthesizer =                                                         always; break;
+            case 't': verbosity.show_time_stream =                                                         always; break;
 //            case 'p': verbosity.show_parser      =                                                         always; break;
-//            default: assert("option must be one of adsyp", false, options[i]);
-            default: assert("option must be one of adsy", false, options[i]);
+//            default: assert("option must be one of adstyp", false, options[i]);
+            default: assert("option must be one of adsty", false, options[i]);
         }
     }
     if (verbosity.show_arguments) {
@@ -1212,6 +2467,7 @@ void parse_verbosity(std::string options) {
         print("  debug output:       "); println(verbosity_level[verbosity.show_debug_info]);
         print("  debug scope output: "); println(verbosity_level[verbosity.show_debug_scope]);
         print("  synthesizer state:  "); println(verbosity_level[verbosity.show_synthesizer]);
+        print("  time stream:        "); println(verbosity_level[verbosity.show_time_stream]);
 //        print("  parser state:       "); println(verbosity_level[verbosity.show_parser]);
         println();
     }
@@ -1229,6 +2485,7 @@ int main (int argc, char **argv) {
         {"verbose",                        no_argument,       0, 'v'},
         {"input",                          required_argument, 0, 'i'},
         {"Infile",                         required_argument, 0, 'I'},
+        {"write_capture",                  required_argument, 0, 'w'},
         {"time",                           required_argument, 0, 't'},
         {"summertime",                     required_argument, 0, 'S'},
         {"Summertime",                     required_argument, 0, 'S'},
@@ -1245,11 +2502,21 @@ int main (int argc, char **argv) {
         {"fade",                           required_argument, 0, 'f'},
         {"random_hf_noise_per_1000",       required_argument, 0, 'r'},
         {"millisecond_samples",            required_argument, 0, 'm'},
+        {"sweep_drift_pp16m",              required_argument, 0, 'X'},
+        {"sweep_random_hf_noise_per_1000", required_argument, 0, 'R'},
+        {"sweep_fade",                     required_argument, 0, 'F'},
+        {"sweep_millisecond_samples",      required_argument, 0, 'M'},
+        {"jobs",                           required_argument, 0, 'j'},
+        {"fork",                           required_argument, 0, 'K'},
+        {"seeds",                          required_argument, 0, 'N'},
+        {"scope_format",                   required_argument, 0, 'o'},
+        {"line_buffered",                  required_argument, 0, 'L'},
+        {"tick_latency",                   required_argument, 0, 'T'},
         {NULL, 0, NULL, 0}
     };
 
     int option_index = 0;
-    while ((c = getopt_long(argc, argv, "hv:t:S:a:c:l:s:d:u:D:i:I:p:P:f:r:m:", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hv:t:S:a:c:l:s:d:u:D:i:I:w:p:P:f:r:m:X:R:F:M:j:K:N:o:L:T:", long_options, &option_index)) != -1) {
         switch (c) {
             case 'h':
                 print("Usage: ");
@@ -1260,22 +2527,32 @@ int main (int argc, char **argv) {
                     "\n"
                     "  -h, --help                                 display this help text\n"
                     "\n"
-//                    "  -v, --view=[adsyp]                         verbose output depending on option set\n"
-                    "  -v, --view=[adsy]                          verbose output depending on option set\n"
+//                    "  -v, --view=[adstyp]                        verbose output depending on option set\n"
+                    "  -v, --view=[adsty]                         verbose output depending on option set\n"
                     "                                               use option d twice to get more output\n"
                     "                                               a: show command line argument parser arguments\n"
                     "                                               d: show debug output\n"
                     "                                               s: show debug scope output\n"
+                    "                                               t: show decoded time and clock state once per second\n"
                     "                                               y: show synthesizer state\n"
 //                    "                                               p: show parser state\n"
                     "\n"
-                    "  -i, --input=[0|1|2]                        define signal source\n"
+                    "  -i, --input=[0|1|2|3]                      define signal source\n"
                     "                                               use signal synthesizer [0],\n"
                     "                                               read from stdin in swiss army debug helper \"scope (Ds)\" format [1],\n"
                     "                                               read from stdin in http://www.dcf77logs.de/ format [2]\n"
+                    "                                               read from file in raw capture format [3]\n"
                     "                                               default: 0\n"
                     "  -I, --Infile=<filename>                    name of input file\n"
-                    "                                               default: "" (= read from stdin)\n"
+                    "                                               default: "" (= read from stdin, not applicable for --input=3)\n"
+                    "  -w, --write_capture=<filename>             record the input signal in raw capture format\n"
+                    "\n"
+                    "  -o, --scope_format=[0|1|2]                 format of the debug scope output (--view=s)\n"
+                    "                                               text [0], CSV [1], binary records [2], default: 0\n"
+                    "  -L, --line_buffered=[0|1]                  write the output line by line [1]\n"
+                    "                                               or in large blocks [0], default: 0\n"
+                    "  -T, --tick_latency=[0|1]                   time each 1 kHz tick and print a latency histogram\n"
+                    "                                               per controller path at the end, default: 0\n"
                     "\n"
                     "                                             Synthesizer options (applicable for --input=0 only):\n"
                     "  -t, --time=YY.MM.DD@hh:mm:ss                 set start date and time, default: <<<TBD>>>\n"
@@ -1303,6 +2580,21 @@ int main (int argc, char **argv) {
                     "  -m, -millisecond_samples=[0|1]               aggregate 10 samples before filtering [0],\n"
                     "                                               process millisecond samples directly [1]\n"
                     "\n"
+                    "                                             Sweep options (applicable for --input=0 only)\n"
+                    "                                               run one scenario per cell of the grid spanned by the sweep options,\n"
+                    "                                               axes without sweep option use the value of the corresponding option above,\n"
+                    "                                               output is one CSV row per cell\n"
+                    "  -X, --sweep_drift_pp16m=list                 list of drifts in parts per 16 million\n"
+                    "  -R, --sweep_random_hf_noise_per_1000=list    list of noise levels\n"
+                    "  -F, --sweep_fade=a,b,c,d,e[/a,b,c,d,e...]    slash separated list of fade parameters\n"
+                    "  -M, --sweep_millisecond_samples=list         list of filter parameters, e.g. 0,1\n"
+                    "  -j, --jobs=n                                 number of worker threads, default: number of cores\n"
+                    "                                             lists are comma separated values or ranges from:to:step\n"
+                    "  -K, --fork=n                                 run the scenario till the clock is synced, then fork\n"
+                    "                                               n continuations with seeds 0..n-1 per cell of the sweep grid\n"
+                    "  -N, --seeds=n                                run each cell of the sweep grid with seeds 0..n-1 and report\n"
+                    "                                               percentiles of the times till dirty, locked and synced\n"
+                    "\n"
                     "Exit status:\n"
                     "  0:  OK\n"
                     "  4:  Invalid option or parameter\n"
@@ -1313,16 +2605,21 @@ int main (int argc, char **argv) {
                 parse_verbosity(optarg);
                 break;
             case 'i': {
-                const uint8_t inp = parse_signed("input", 1, 1, 3, optarg);
+                const uint8_t inp = parse_signed("input", 1, 1, 4, optarg);
                 if (verbosity.show_arguments) { print("input: "); println((int)inp); }
                 signal_source = inp == 0 ? synthesizer : filesystem;
-                file_format   = inp == 1 ? swiss_army_debug_helper_scope : dcf77_logs_de;
+                file_format   = inp == 1 ? swiss_army_debug_helper_scope :
+                                inp == 3 ? bit_packed_capture            : dcf77_logs_de;
                 break;
             }
             case 'I':
                 if (verbosity.show_arguments) { print("Infile: "); println(optarg); }
                 file_name = optarg;
                 break;
+            case 'w':
+                if (verbosity.show_arguments) { print("write_capture: "); println(optarg); }
+                capture_file_name = optarg;
+                break;
             case 't':
                 parse_start_time(
                     synthesizer_parameters.year,
@@ -1359,8 +2656,21 @@ int main (int argc, char **argv) {
                       if (signal_shaper_parameters.random_hf_noise_per_1000 > 1000) { signal_shaper_parameters.random_hf_noise_per_1000 = 1000; }
                       break;
             case 'm': high_phase_lock_resolution = parse_boolean("millisecond_samples", optarg); break;
+
+            case 'X': parse_sweep_list("sweep_drift_pp16m", 7, -9999999, 9999999, optarg, Sweep::drift_pp16m);          break;
+            case 'R': parse_sweep_list("sweep_random_hf_noise_per_1000", 4, 0, 1000, optarg, Sweep::random_hf_noise_per_1000); break;
+            case 'F': parse_sweep_fade(optarg);                                                                          break;
+            case 'M': parse_sweep_list("sweep_millisecond_samples", 1, 0, 1, optarg, Sweep::high_phase_lock_resolution);  break;
+            case 'j': Sweep::jobs = parse_unsigned("jobs", 1, 4, 10, optarg);                                            break;
+            case 'K': Fork::continuations = parse_unsigned("fork", 1, 6, 10, optarg);                                    break;
+            case 'N': Monte_Carlo::seeds = parse_unsigned("seeds", 1, 6, 10, optarg);                                    break;
+            case 'o': scope_format = (scope_format_t)parse_unsigned("scope_format", 1, 1, 3, optarg);                    break;
+            case 'L': Output::sink.flush_policy = parse_boolean("line_buffered", optarg)? Output::each_line: Output::when_full; break;
+            case 'T': Tick_Profiler::enabled = parse_boolean("tick_latency", optarg);                                    break;
             default:
-                printf("?? getopt returned character code 0%o ??\n", c);
+                print("?? getopt returned character code 0");
+                print((unsigned long)c, OCT);
+                println(" ??");
                 exit(4);
         }
     }
@@ -1374,7 +2684,20 @@ int main (int argc, char **argv) {
         exit(4);
     }
 
-    run(argc, argv);
+    if (Fork::enabled() && Monte_Carlo::enabled()) {
+        println("--fork and --seeds can not be combined");
+        exit(4);
+    }
+
+    if (Fork::enabled()) {
+        Fork::run();
+    } else if (Monte_Carlo::enabled()) {
+        Monte_Carlo::run();
+    } else if (Sweep::enabled()) {
+        Sweep::run();
+    } else {
+        run(argc, argv);
+    }
 
     exit (0);
 }
@@ -25,6 +25,7 @@ const bool verbose = false;
 #include <iostream>
 #include <string>
 #include <stdio.h>
+#include <string.h>
 
 // start of definitions to ensure the DCF77 library has all the Arduino stuff it requires compile
 #include <stdint.h>
@@ -47,37 +48,99 @@ const int OCT =  8;
 const int DEC = 10;
 const int HEX = 16;
 
-class FakeSerial {
-private:
-    void print_formatted_not_0(unsigned long d, int f) {
-        if (d < f) {
-            std::cout << d;
-        } else {
-            print_formatted_not_0(d / f, f);
-            std::cout << (d % f);
+// All output of the debug helper and of the library (sprint/sprintln --> Serial)
+// ends up in std::cout. The sink replaces the buffer of std::cout by a large one.
+// By default it is written only if it is full or if it is flushed explicitly.
+// Thus verbose runs are no longer slowed down by flushing each and every line.
+// The remaining output is flushed at exit. If the output shall be watched while
+// a long simulation is running the flush policy can be set to each_line.
+namespace Output {
+    enum flush_policy_t : uint8_t { when_full = 0, each_line = 1 };
+
+    class sink_t : public std::streambuf {
+    public:
+        flush_policy_t flush_policy = when_full;
+
+        sink_t() : original(std::cout.rdbuf(this)) {
+            setp(buffer, buffer + sizeof(buffer));
         }
-    }
 
-    void print_formatted(unsigned long d, int f) {
-        if (d==0) {
-            std::cout << d;
-        } else {
-            print_formatted_not_0(d, f);
+        ~sink_t() {
+            // std::cout outlives the sink, hence it must get back its own buffer
+            sync();
+            std::cout.rdbuf(original);
+        }
+
+        void end_line() {
+            std::cout.rdbuf()->sputc('\n');
+            if (flush_policy == each_line) {
+                sync();
+            }
+        }
+
+    protected:
+        int_type overflow(int_type c) override {
+            if (write_buffer() != 0) {
+                return traits_type::eof();
+            }
+            if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(c);
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+
+        int sync() override {
+            return write_buffer();
         }
+
+    private:
+        char buffer[1 << 16];
+        std::streambuf *original;
+
+        int write_buffer() {
+            const std::streamsize size = pptr() - pbase();
+            if (size > 0 && original->sputn(pbase(), size) != size) {
+                return -1;
+            }
+            setp(buffer, buffer + sizeof(buffer));
+            return original->pubsync();
+        }
+    };
+
+    sink_t sink;
+}
+
+// Characters, strings and unsigned numbers are written directly into the buffer
+// of std::cout. This saves setting up the stream for each of them, which would
+// take longer than the actual output.
+class FakeSerial {
+private:
+    void print_formatted(unsigned long d, int f) {
+        // digits from right to left, BIN needs the most of them.
+        // Upper case hex digits just like the Arduino's Serial.print.
+        char digits[8 * sizeof(unsigned long)];
+        uint8_t first = sizeof(digits);
+        do {
+            digits[--first] = "0123456789ABCDEF"[d % f];
+            d /= f;
+        } while (d > 0);
+
+        std::cout.rdbuf()->sputn(digits + first, sizeof(digits) - first);
     }
 
 public:
     void print() { };
-    void print(char          d )             { std::cout << d; };
-    void print(unsigned long d, int f = DEC) { if (f == DEC) { std::cout <<      d; } else { print_formatted(d, f); } };
+    void print(char          d )             { std::cout.rdbuf()->sputc(d); };
+    void print(unsigned long d, int f = DEC) { print_formatted(d, f); };
     void print(long          d, int f = DEC) { if (f == DEC) { std::cout <<      d; } else { print((unsigned long)d, f); } };
-    void print(unsigned char d, int f = DEC) { if (f == DEC) { std::cout << (int)d; } else { print((unsigned long)d, f); } };
+    void print(unsigned char d, int f = DEC) { print_formatted(d, f); };
     void print(int           d, int f = DEC) { if (f == DEC) { std::cout <<      d; } else { print((unsigned long)d, f); } };
-    void print(unsigned int  d, int f = DEC) { if (f == DEC) { std::cout <<      d; } else { print((unsigned long)d, f); } };
-    void print(const char   *d)              { while (*d) { std::cout << *d; ++d; } };
+    void print(unsigned int  d, int f = DEC) { print_formatted(d, f); };
+    void print(const char   *d)              { std::cout.rdbuf()->sputn(d, strlen(d)); };
     void print(double        d, int f = 2)   { std::cout << d; };
 
-    void println() { std::cout << std::endl; };
+    void println() { Output::sink.end_line(); };
     void println(char          d)              { print(d);    println(); };
     void println(unsigned char d, int f = DEC) { print(d, f); println(); };
     void println(int           d, int f = DEC) { print(d, f); println(); };
@@ -91,6 +154,26 @@ public:
 
 extern FakeSerial Serial;
 
+// The tick latency profiler (--tick_latency) tags each 1 kHz tick by the
+// expensive paths of the clock controller that ran during the tick.
+namespace Tick_Profiler {
+    enum path_t : uint8_t {
+        decode            = 0x01,  // process_single_tick_data, about once per second
+        flush             = 0x02,  // flush of the decoded time
+        local_clock_flush = 0x04,  // frequency control, output handler
+        compute_max_index = 0x08,  // scan of the bins of a decoder, fused into the last bit for BCD
+        convolution_time  = 0x10,  // set_convolution_time, second 15
+        phase_lost        = 0x20,  // reset of the decoders
+        sync_lost         = 0x40,  // partial reset of the decoders
+        work_slice        = 0x80   // slice of the amortized 1 Hz work
+    };
+    const uint8_t path_count = 8;
+
+    // per thread, the sweep and Monte Carlo workers run their own controllers
+    thread_local uint8_t current_paths = 0;
+}
+#define DCF77_MARK_TICK_PATH(path) (::Tick_Profiler::current_paths |= ::Tick_Profiler::path)
+
 #include "../../dcf77.h"
 // end of definitions to ensure the DCF77 library has all the Arduino stuff it requires compile
 
@@ -108,10 +191,11 @@ extern FakeSerial Serial;
 
     template <typename T>
     void println(T v) {
-        std::cout << v << "\n";
+        std::cout << v;
+        Output::sink.end_line();
     }
 
-    void println() { std::cout << std::endl; }
+    void println() { Output::sink.end_line(); }
 
 
     template <typename T, typename... Args>
@@ -0,0 +1,220 @@
+#!/usr/bin/env python
+
+"""Replay all logs of the regression corpus and compare the results to the
+golden files.
+
+Each log in test_resources is replayed with the standalone debug helper once
+per filter setting (--millisecond_samples=0 and 1). The helper's time stream
+(--view=t) with one line
+
+Decoded time: 18-05-14 1 19:36:05 CEST .. synced
+
+per second is condensed into segments of consecutive seconds with the same
+clock state. The segments are compared to test_resources/golden/<log>.m<0|1>.golden.
+The logs are replayed concurrently, the wall clock time of each replay is
+reported as well as the replay speed relative to real time.
+
+Use --update to (re)create the golden files after an intended change of the
+decoder's behaviour.
+
+Builds that flush the time at a slightly different phase, e.g. with fine phase
+tracking, may see a second repeated or skipped where the log has a gap. For
+them --variant_dir holds the golden files that differ from the common ones.
+If a golden file exists in the variant directory it takes precedence. With
+--update only the differing golden files are written to the variant directory.
+
+Builds without the date decoders (-DDECODE_DATE=0) print the undefined date
+as FF-FF-FF F. Their time advances modulo one day.
+"""
+
+from __future__ import print_function
+
+import argparse
+import datetime
+import glob
+import multiprocessing
+import multiprocessing.pool
+import os
+import re
+import subprocess
+import sys
+import time
+
+
+#                  Decoded time:   1 8 -  0 5 -  1 4   1   1 9 :  3 6 :  0 5         C E S T   . .     s y n c e d
+regex = re.compile(r'^Decoded time: (?:(?:(\d\d)-(\d\d)-(\d\d) \d|(FF-FF-FF F)) (\d\d):(\d\d):(\d\d) (\S+) (\S\S)|none) (\w+)$')
+
+one_second = datetime.timedelta(seconds=1)
+seconds_per_day = 24 * 60 * 60
+
+
+def parse_time(match):
+    if match.group(5) is None:
+        return None
+    hour, minute, second = (int(x) for x in match.group(5, 6, 7))
+    leap = 1 if second == 60 else 0
+    # leap second, keep it distinguishable from the next second
+    second -= leap
+    if match.group(4) is not None:
+        # undefined date, the time of day only
+        return (datetime.timedelta(hours=hour, minutes=minute, seconds=second), leap)
+    year, month, day = (int(x) for x in match.group(1, 2, 3))
+    return (datetime.datetime(2000 + year, month, day, hour, minute, second), leap)
+
+
+def step(previous_time, current_time):
+    """'+' if the time advanced by one second, '=' if it did not change, None otherwise"""
+    if previous_time == current_time:
+        return '='
+    if previous_time is None or current_time is None:
+        return None
+    if type(current_time[0]) != type(previous_time[0]):
+        return None
+    if current_time[1] == 1:
+        return '+' if current_time[0] == previous_time[0] and previous_time[1] == 0 else None
+    if isinstance(current_time[0], datetime.timedelta):
+        return '+' if (current_time[0] - previous_time[0]).total_seconds() % seconds_per_day == 1 else None
+    return '+' if current_time[0] - previous_time[0] == one_second else None
+
+
+def segments(output):
+    """Condense the time stream into lines
+
+    <first second> <number of seconds> <clock state> <+|=|.> <decoded time of first second>
+
+    Within a segment the clock state is constant and the decoded time either
+    advances by exactly one second per second (+) or it does not change at all (=).
+    Segments of a single second are marked by a dot.
+    """
+    result = []
+    second = 0
+    previous_time = None
+    previous_state = None
+    segment = None  # [first second, clock state, step, decoded time]
+
+    def flush():
+        result.append('%d %d %s %s %s' % (segment[0], second - segment[0], segment[1], segment[2] or '.', segment[3]))
+
+    for line in output.splitlines():
+        match = regex.match(line)
+        if not match:
+            continue
+
+        text = line[len('Decoded time: '):line.rfind(' ')]
+        current_time = parse_time(match)
+        state = match.group(10)
+
+        if segment is not None and state == previous_state and segment[2] is None:
+            # the second second of a segment determines its step
+            segment[2] = step(previous_time, current_time)
+        if segment is None or state != previous_state or segment[2] is None or step(previous_time, current_time) != segment[2]:
+            if segment is not None:
+                flush()
+            segment = [second, state, None, text]
+
+        second += 1
+        previous_time = current_time
+        previous_state = state
+
+    if segment is not None:
+        flush()
+    return result
+
+
+def golden_file_name(golden_dir, log, millisecond_samples):
+    return os.path.join(golden_dir, '%s.m%d.golden' % (os.path.splitext(os.path.basename(log))[0], millisecond_samples))
+
+
+def replay(arguments, log, millisecond_samples):
+    command = [arguments.binary, '-i2', '-I', log, '-m%d' % millisecond_samples, '-vt']
+    start = time.time()
+    process = subprocess.Popen(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    output, _ = process.communicate()
+    wall_time = time.time() - start
+
+    result = segments(output)
+    seconds = sum(int(line.split()[1]) for line in result)
+    golden = golden_file_name(arguments.golden_dir, log, millisecond_samples)
+    variant = golden_file_name(arguments.variant_dir, log, millisecond_samples) if arguments.variant_dir else None
+
+    if process.returncode != 0:
+        return (log, millisecond_samples, 'ERROR', wall_time, seconds, 'exit status %d' % process.returncode)
+
+    if arguments.update:
+        text = '\n'.join(result) + '\n'
+        if variant:
+            common = None
+            if os.path.exists(golden):
+                with open(golden) as golden_file:
+                    common = golden_file.read()
+            if text == common:
+                if os.path.exists(variant):
+                    os.remove(variant)
+                return (log, millisecond_samples, 'UPDATED', wall_time, seconds, '')
+            golden = variant
+        with open(golden, 'w') as golden_file:
+            golden_file.write(text)
+        return (log, millisecond_samples, 'UPDATED', wall_time, seconds, '')
+
+    if variant and os.path.exists(variant):
+        golden = variant
+
+    if not os.path.exists(golden):
+        return (log, millisecond_samples, 'MISSING', wall_time, seconds, golden)
+
+    with open(golden) as golden_file:
+        expected = golden_file.read().splitlines()
+
+    for line_no, (expected_line, actual_line) in enumerate(zip(expected, result)):
+        if expected_line != actual_line:
+            return (log, millisecond_samples, 'FAIL', wall_time, seconds,
+                    'segment %d\n    expected: %s\n    actual:   %s' % (line_no + 1, expected_line, actual_line))
+    if len(expected) != len(result):
+        return (log, millisecond_samples, 'FAIL', wall_time, seconds,
+                'expected %d segments, got %d' % (len(expected), len(result)))
+
+    return (log, millisecond_samples, 'PASS', wall_time, seconds, '')
+
+
+def main():
+    script_dir = os.path.dirname(os.path.abspath(__file__))
+
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('logs', nargs='*', help='logs to replay, default: all logs in test_resources')
+    parser.add_argument('-b', '--binary', default=os.path.join(script_dir, 'main'), help='standalone debug helper binary')
+    parser.add_argument('-g', '--golden_dir', default=os.path.join(script_dir, 'test_resources', 'golden'))
+    parser.add_argument('-V', '--variant_dir', help='golden files of this build that differ from the common ones')
+    parser.add_argument('-j', '--jobs', type=int, default=multiprocessing.cpu_count(), help='number of concurrent replays')
+    parser.add_argument('-u', '--update', action='store_true', help='(re)create the golden files')
+    arguments = parser.parse_args()
+
+    logs = arguments.logs or sorted(glob.glob(os.path.join(script_dir, 'test_resources', '*.log')))
+    if arguments.update and not os.path.isdir(arguments.golden_dir):
+        os.makedirs(arguments.golden_dir)
+    if arguments.update and arguments.variant_dir and not os.path.isdir(arguments.variant_dir):
+        os.makedirs(arguments.variant_dir)
+
+    jobs = [(log, millisecond_samples) for log in logs for millisecond_samples in (0, 1)]
+
+    start = time.time()
+    pool = multiprocessing.pool.ThreadPool(max(1, arguments.jobs))
+    results = pool.map(lambda job: replay(arguments, job[0], job[1]), jobs)
+    pool.close()
+    wall_time = time.time() - start
+
+    failures = 0
+    total_seconds = 0
+    for log, millisecond_samples, status, replay_time, seconds, details in results:
+        total_seconds += seconds
+        print('%-8s %-32s -m%d  %8.3f s  %7d s signal  %8.0fx real time' %
+              (status, os.path.basename(log), millisecond_samples, replay_time, seconds, seconds / max(replay_time, 1e-6)))
+        if details:
+            print('    ' + details)
+        failures += status not in ('PASS', 'UPDATED')
+
+    print('%d replays, %d failed, %d s signal in %.3f s wall clock time' % (len(results), failures, total_seconds, wall_time))
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())